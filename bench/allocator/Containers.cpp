@@ -0,0 +1,85 @@
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <afina/allocator/Adapter.h>
+#include <afina/allocator/Simple.h>
+
+using namespace Afina;
+
+/**
+ * Container churn with default allocator and with Allocator::Adapter over fixed area: vectors built by push_back
+ * and dropped, and hash map under mixed insert/erase load.
+ */
+
+namespace {
+
+const std::size_t area_size = 64 << 20;
+const std::size_t rounds = 20000;
+const std::size_t map_keys = 100000;
+const std::size_t map_ops = 4000000;
+
+void Report(const char *name, std::chrono::steady_clock::time_point start, std::size_t ops) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-8s %7.2f Mops/s\n", name, ops / elapsed.count() / 1e6);
+}
+
+template <typename Alloc> void VectorChurn(const char *name, const Alloc &alloc) {
+    std::size_t ops = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; r++) {
+        std::vector<std::vector<int, Alloc>> vectors;
+        for (std::size_t v = 0; v < 8; v++) {
+            vectors.emplace_back(alloc);
+            for (std::size_t i = 0; i < (r % 64) * 16; i++) {
+                vectors.back().push_back(int(i));
+                ops++;
+            }
+        }
+    }
+    Report(name, start, ops);
+}
+
+template <typename Alloc> void MapChurn(const char *name, const Alloc &alloc) {
+    std::unordered_map<std::size_t, std::size_t, std::hash<std::size_t>, std::equal_to<std::size_t>, Alloc> map(
+        16, std::hash<std::size_t>(), std::equal_to<std::size_t>(), alloc);
+
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<std::size_t> key(0, map_keys - 1);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < map_ops; i++) {
+        std::size_t k = key(gen);
+        auto it = map.find(k);
+        if (it != map.end()) {
+            map.erase(it);
+        } else {
+            map.emplace(k, i);
+        }
+    }
+    Report(name, start, map_ops);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::unique_ptr<char[]> area(new char[area_size]);
+
+    std::printf("vector push_back churn\n");
+    VectorChurn("default", std::allocator<int>());
+    {
+        Allocator::Simple simple(area.get(), area_size);
+        VectorChurn("simple", Allocator::Adapter<int>(simple));
+    }
+
+    std::printf("unordered_map insert/erase churn, %zu keys\n", map_keys);
+    MapChurn("default", std::allocator<std::pair<const std::size_t, std::size_t>>());
+    {
+        Allocator::Simple simple(area.get(), area_size);
+        MapChurn("simple", Allocator::Adapter<std::pair<const std::size_t, std::size_t>>(simple));
+    }
+    return 0;
+}
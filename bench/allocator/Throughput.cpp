@@ -0,0 +1,157 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/Concurrent.h>
+
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+using namespace Afina;
+
+/**
+ * Replays the same alloc/free trace against glibc malloc and Allocator::Simple. Trace keeps a fixed number of slots
+ * and toggles random one on each step: frees block if slot is taken, allocates a block of random size otherwise.
+ * Simple runs over an area about twice as large as the average live set, so it has to defragment itself regularly.
+ *
+ * Then the same trace is replayed by several threads at once against malloc and Allocator::Concurrent, each thread
+ * with its own slots.
+ */
+
+namespace {
+
+const std::size_t slots_count = 4096;
+const std::size_t ops_count = 4000000;
+
+struct op {
+    std::size_t slot;
+    std::size_t size;
+};
+
+std::vector<op> Trace(std::size_t min_size, std::size_t max_size, unsigned seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<std::size_t> slot(0, slots_count - 1);
+    std::uniform_int_distribution<std::size_t> size(min_size, max_size);
+
+    std::vector<op> trace(ops_count);
+    for (auto &o : trace) {
+        o.slot = slot(gen);
+        o.size = size(gen);
+    }
+    return trace;
+}
+
+void Report(const char *name, std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-8s %7.2f Mops/s\n", name, ops_count / elapsed.count() / 1e6);
+}
+
+void Malloc(const std::vector<op> &trace) {
+    std::vector<void *> slots(slots_count, nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto &o : trace) {
+        if (slots[o.slot] != nullptr) {
+            std::free(slots[o.slot]);
+            slots[o.slot] = nullptr;
+        } else {
+            slots[o.slot] = std::malloc(o.size);
+            std::memset(slots[o.slot], 0, sizeof(void *));
+        }
+    }
+    Report("malloc", start);
+
+    for (auto p : slots) {
+        std::free(p);
+    }
+}
+
+void Simple(const std::vector<op> &trace, std::size_t area_size) {
+    std::vector<char> area(area_size);
+    Allocator::Simple allocator(area.data(), area.size());
+    std::vector<Allocator::Pointer> slots(slots_count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto &o : trace) {
+        Allocator::Pointer &p = slots[o.slot];
+        if (p.get() != nullptr) {
+            allocator.free(p);
+            continue;
+        }
+
+        p = allocator.alloc(o.size);
+        std::memset(p.get(), 0, sizeof(void *));
+    }
+    Report("simple", start);
+}
+
+void Run(std::size_t min_size, std::size_t max_size) {
+    std::printf("%zu live blocks of %zu..%zu bytes\n", slots_count / 2, min_size, max_size);
+
+    auto trace = Trace(min_size, max_size, 42);
+    Malloc(trace);
+    // Twice the average live set, header and descriptor included
+    Simple(trace, slots_count * ((min_size + max_size) / 2 + 32));
+}
+
+// Runs trace in every thread using given alloc and free, reports total throughput
+void Threads(const char *name, const std::vector<op> &trace, std::size_t threads,
+             std::function<void *(std::size_t)> alloc, std::function<void(void *)> free) {
+    auto worker = [&]() {
+        std::vector<void *> slots(slots_count, nullptr);
+        for (auto &o : trace) {
+            if (slots[o.slot] != nullptr) {
+                free(slots[o.slot]);
+                slots[o.slot] = nullptr;
+            } else {
+                slots[o.slot] = alloc(o.size);
+                std::memset(slots[o.slot], 0, sizeof(void *));
+            }
+        }
+        for (auto p : slots) {
+            free(p);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; i++) {
+        workers.emplace_back(worker);
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-10s %zu threads %7.2f Mops/s\n", name, threads, threads * ops_count / elapsed.count() / 1e6);
+}
+
+void RunThreads(std::size_t min_size, std::size_t max_size) {
+    std::printf("%zu live blocks of %zu..%zu bytes per thread\n", slots_count / 2, min_size, max_size);
+
+    auto trace = Trace(min_size, max_size, 42);
+    for (std::size_t threads : {1, 2, 4, 8}) {
+        Threads("malloc", trace, threads, [](std::size_t size) { return std::malloc(size); },
+                [](void *p) { std::free(p); });
+
+        Allocator::Concurrent concurrent(std::size_t(1) << 30);
+        Threads("concurrent", trace, threads, [&](std::size_t size) { return concurrent.alloc(size); },
+                [&](void *p) { concurrent.free(p); });
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Run(16, 64);
+    Run(64, 512);
+    Run(512, 4096);
+
+    RunThreads(16, 64);
+    RunThreads(64, 512);
+    return 0;
+}
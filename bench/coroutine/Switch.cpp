@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdio>
+#include <initializer_list>
+
+#include <afina/coroutine/Engine.h>
+#include <afina/coroutine/StackEngine.h>
+
+using namespace Afina;
+
+/**
+ * Two coroutines pass control to each other with sched, each from under a given amount of its own stack. Reports
+ * average cost of a single switch for Engine, which copies stack of the routine out and in on every switch, and
+ * StackEngine, which only swaps registers.
+ *
+ * Then main coroutine starts short routines one after another, as server does for each connection. Reports cost of
+ * a routine from run to its end, with context pool and without one.
+ */
+
+namespace {
+
+const std::size_t switches_count = 200000;
+const std::size_t routines_count = 100000;
+
+template <typename E> struct PingPong {
+    E *engine;
+    void *routines[2];
+    std::size_t depth;
+};
+
+// Burns `left` bytes of stack in 1K frames, then passes control to the other routine over and over
+template <typename E> void Dive(PingPong<E> &game, int self, std::size_t left) {
+    volatile char frame[1024];
+    frame[0] = 0;
+    if (left >= sizeof(frame)) {
+        Dive(game, self, left - sizeof(frame));
+        return;
+    }
+
+    for (std::size_t i = 0; i < switches_count / 2; i++) {
+        game.engine->sched(game.routines[1 - self]);
+    }
+}
+
+template <typename E> void Player(PingPong<E> &game, int self) { Dive(game, self, game.depth); }
+
+template <typename E> void Main(PingPong<E> &game) {
+    game.routines[0] = game.engine->run(&Player<E>, game, 0);
+    game.routines[1] = game.engine->run(&Player<E>, game, 1);
+    game.engine->sched(game.routines[0]);
+}
+
+template <typename E> double Measure(std::size_t depth) {
+    E engine;
+    PingPong<E> game;
+    game.engine = &engine;
+    game.depth = depth;
+
+    auto start = std::chrono::steady_clock::now();
+    engine.start(&Main<E>, game);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / switches_count;
+}
+
+void Short(int &counter) { counter++; }
+
+template <typename E> void Spawner(E &engine, int &counter) {
+    for (std::size_t i = 0; i < routines_count; i++) {
+        engine.sched(engine.run(&Short, counter));
+    }
+}
+
+template <typename E> double MeasureSpawn(E &engine) {
+    int counter = 0;
+    auto start = std::chrono::steady_clock::now();
+    engine.start(&Spawner<E>, engine, counter);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / routines_count;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::printf("%10s %12s %12s\n", "stack", "Engine", "StackEngine");
+    for (std::size_t depth : {0, 1024, 4096, 16384, 65536}) {
+        double copying = Measure<Coroutine::Engine>(depth);
+        double dedicated = Measure<Coroutine::StackEngine>(depth);
+        std::printf("%9zuB %9.1f ns %9.1f ns\n", depth, copying, dedicated);
+    }
+
+    std::printf("\n%10s %12s %12s\n", "routine", "Engine", "StackEngine");
+    {
+        Coroutine::Engine copying(0);
+        Coroutine::StackEngine dedicated(Coroutine::StackEngine::default_stack_size, 0);
+        std::printf("%10s %9.1f ns %9.1f ns\n", "no pool", MeasureSpawn(copying), MeasureSpawn(dedicated));
+    }
+    {
+        Coroutine::Engine copying;
+        Coroutine::StackEngine dedicated;
+        double copying_ns = MeasureSpawn(copying), dedicated_ns = MeasureSpawn(dedicated);
+        std::printf("%10s %9.1f ns %9.1f ns\n", "pool", copying_ns, dedicated_ns);
+        std::printf("%10s %9.4f    %9.4f\n", "hit ratio",
+                    double(copying.pool_stats().hits) / (copying.pool_stats().hits + copying.pool_stats().misses),
+                    double(dedicated.pool_stats().hits) /
+                        (dedicated.pool_stats().hits + dedicated.pool_stats().misses));
+    }
+    return 0;
+}
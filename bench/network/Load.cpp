@@ -0,0 +1,146 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * Load generator for a running server: every connection sends batches of pipelined small GETs and waits for all
+ * the responses before sending next batch. Reports requests per second, so network layers could be compared on
+ * the same box:
+ *
+ *   ./src/afina --network mt_nonblock --storage st_lru_hash --storage_size 10000000 &
+ *   ./bench/network/runNetworkBench 8080 64 16 10
+ */
+
+namespace {
+
+int Connect(uint16_t port) {
+    int s = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == -1) {
+        throw std::runtime_error("Failed to open socket");
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(s);
+        throw std::runtime_error("Failed to connect");
+    }
+
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return s;
+}
+
+void SendAll(int s, const std::string &data) {
+    for (std::size_t sent = 0; sent < data.size();) {
+        ssize_t n = send(s, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            throw std::runtime_error("Failed to send");
+        }
+        sent += n;
+    }
+}
+
+// Reads until the given number of terminators arrived
+void Expect(int s, const char *terminator, std::size_t count) {
+    std::size_t len = std::strlen(terminator);
+    std::size_t matched = 0, seen = 0;
+    char buf[16384];
+    while (seen < count) {
+        ssize_t n = recv(s, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            throw std::runtime_error("Connection closed");
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            matched = (buf[i] == terminator[matched]) ? matched + 1 : (buf[i] == terminator[0] ? 1 : 0);
+            if (matched == len) {
+                seen++;
+                matched = 0;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    uint16_t port = argc > 1 ? std::atoi(argv[1]) : 8080;
+    std::size_t connections = argc > 2 ? std::atoi(argv[2]) : 64;
+    std::size_t pipeline = argc > 3 ? std::atoi(argv[3]) : 16;
+    int seconds = argc > 4 ? std::atoi(argv[4]) : 10;
+    std::size_t threads = std::min<std::size_t>(connections, std::max(1u, std::thread::hardware_concurrency()));
+
+    try {
+        int s = Connect(port);
+        SendAll(s, "set bench 0 0 8\r\n12345678\r\n");
+        Expect(s, "\r\n", 1);
+        close(s);
+    } catch (std::runtime_error &ex) {
+        std::fprintf(stderr, "Server on port %d isn't reachable: %s\n", port, ex.what());
+        return 1;
+    }
+
+    std::string batch;
+    for (std::size_t i = 0; i < pipeline; i++) {
+        batch += "get bench\r\n";
+    }
+
+    std::atomic<bool> running(true);
+    std::atomic<std::size_t> total(0);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            // Connections of the thread take turns, so every one keeps a batch in flight
+            std::vector<int> sockets;
+            for (std::size_t c = t; c < connections; c += threads) {
+                sockets.push_back(Connect(port));
+            }
+
+            std::size_t done = 0;
+            try {
+                while (running) {
+                    for (int s : sockets) {
+                        SendAll(s, batch);
+                    }
+                    for (int s : sockets) {
+                        Expect(s, "END\r\n", pipeline);
+                        done += pipeline;
+                    }
+                }
+            } catch (std::runtime_error &ex) {
+                std::fprintf(stderr, "%s\n", ex.what());
+            }
+            total += done;
+
+            for (int s : sockets) {
+                close(s);
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running = false;
+    for (auto &w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%zu connections, pipeline %zu: %.0f requests/s\n", connections, pipeline, total / elapsed.count());
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/FlatCombineLRU.h"
+#include "storage/ShardedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+/**
+ * Hammers the same small set of keys from a growing number of threads, 90% Get and 10% Put, and reports total
+ * throughput. Shows how a single mutex, flat combining and lock striping behave once threads start to collide.
+ */
+
+namespace {
+
+const std::size_t keys_count = 1024;
+const std::size_t value_size = 64;
+const double seconds = 1.0;
+
+std::string Key(std::size_t k) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "key:%010zu", k);
+    return buf;
+}
+
+double Hammer(Storage &storage, std::size_t threads) {
+    std::vector<std::string> keys(keys_count);
+    for (std::size_t i = 0; i < keys_count; i++) {
+        keys[i] = Key(i);
+        storage.Put(keys[i], std::string(value_size, 'v'));
+    }
+    const std::string value(value_size, 'w');
+
+    std::atomic<bool> go(false), stop(false);
+    std::atomic<std::size_t> total(0);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::minstd_rand gen(t + 1);
+            std::string out;
+            std::size_t ops = 0;
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto r = gen();
+                const std::string &key = keys[r % keys_count];
+                if (r % 10 == 0) {
+                    storage.Put(key, value);
+                } else {
+                    storage.Get(key, out);
+                }
+                ops++;
+            }
+            total += ops;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto &w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return total.load() / elapsed.count() / 1e6;
+}
+
+typedef std::function<std::unique_ptr<Storage>(std::size_t)> factory;
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::size_t max_threads = 2 * std::thread::hardware_concurrency();
+    if (argc > 1) {
+        max_threads = std::strtoul(argv[1], nullptr, 10);
+    }
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+    const std::size_t budget = 2 * keys_count * (Key(0).size() + value_size);
+
+    std::vector<std::pair<const char *, factory>> engines = {
+        {"mt_lru", [](std::size_t size) { return std::unique_ptr<Storage>(new Backend::ThreadSafeSimplLRU(size)); }},
+        {"fc_lru", [](std::size_t size) { return std::unique_ptr<Storage>(new Backend::FlatCombineLRU(size)); }},
+        {"sharded_lru", [](std::size_t size) { return std::unique_ptr<Storage>(new Backend::ShardedLRU(size)); }},
+    };
+
+    std::printf("%zu keys, 90%% Get, 10%% Put, Mops/s\n", keys_count);
+    std::printf("  %-8s", "threads");
+    for (auto &e : engines) {
+        std::printf(" %12s", e.first);
+    }
+    std::printf("\n");
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        std::printf("  %-8zu", threads);
+        for (auto &e : engines) {
+            auto storage = e.second(budget);
+            std::printf(" %12.2f", Hammer(*storage, threads));
+            std::fflush(stdout);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/ClockCache.h"
+#include "storage/HashLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/SlabLRU.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina;
+
+/**
+ * Replays the same key trace against every storage in cache-aside manner: Get, and Put on miss. Reports hit ratio
+ * and throughput, all storages get the same byte budget.
+ */
+
+namespace {
+
+const std::size_t keys_count = 100000;
+const std::size_t ops_count = 2000000;
+const std::size_t value_size = 64;
+
+// Zipfian distributed key numbers, inverse CDF over precomputed table
+std::vector<std::size_t> ZipfTrace(std::size_t keys, std::size_t ops, double skew, unsigned seed) {
+    std::vector<double> cdf(keys);
+    double sum = 0;
+    for (std::size_t i = 0; i < keys; i++) {
+        sum += 1.0 / std::pow(double(i + 1), skew);
+        cdf[i] = sum;
+    }
+
+    // Shuffle ranks, so popular keys aren't neighbours in the key space
+    std::vector<std::size_t> rank(keys);
+    for (std::size_t i = 0; i < keys; i++) {
+        rank[i] = i;
+    }
+    std::mt19937_64 gen(seed);
+    std::shuffle(rank.begin(), rank.end(), gen);
+
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<std::size_t> trace(ops);
+    for (auto &k : trace) {
+        k = rank[std::lower_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin()];
+    }
+    return trace;
+}
+
+// Zipfian trace interrupted by full sequential scans over the whole key space every period operations
+std::vector<std::size_t> ScanTrace(const std::vector<std::size_t> &zipf, std::size_t keys, std::size_t period) {
+    std::vector<std::size_t> trace;
+    trace.reserve(zipf.size() + zipf.size() / period * keys);
+    for (std::size_t i = 0; i < zipf.size(); i++) {
+        trace.push_back(zipf[i]);
+        if ((i + 1) % period == 0) {
+            for (std::size_t k = 0; k < keys; k++) {
+                trace.push_back(k);
+            }
+        }
+    }
+    return trace;
+}
+
+std::string Key(std::size_t k) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "key:%010zu", k);
+    return buf;
+}
+
+void Replay(const char *name, Storage &storage, const std::vector<std::size_t> &trace) {
+    std::vector<std::string> keys(keys_count);
+    for (std::size_t i = 0; i < keys_count; i++) {
+        keys[i] = Key(i);
+    }
+    const std::string value(value_size, 'v');
+
+    std::size_t hits = 0;
+    std::string out;
+    auto start = std::chrono::steady_clock::now();
+    for (auto k : trace) {
+        if (storage.Get(keys[k], out)) {
+            hits++;
+        } else {
+            storage.Put(keys[k], value);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("  %-12s hit ratio %6.2f%%   %7.2f Mops/s\n", name, 100.0 * hits / trace.size(),
+                trace.size() / elapsed.count() / 1e6);
+}
+
+typedef std::function<std::unique_ptr<Storage>(std::size_t)> factory;
+
+void Run(const char *title, const std::vector<std::size_t> &trace, std::size_t budget) {
+    std::printf("%s, budget %zu bytes\n", title, budget);
+
+    std::vector<std::pair<const char *, factory>> engines = {
+        {"st_lru", [](std::size_t size) { return std::unique_ptr<Storage>(new Backend::SimpleLRU(size)); }},
+        {"st_lru_hash", [](std::size_t size) { return std::unique_ptr<Storage>(new Backend::HashLRU(size)); }},
+        {"st_lru_slab", [](std::size_t size) { return std::unique_ptr<Storage>(new Backend::SlabLRU(size)); }},
+        {"clock", [](std::size_t size) { return std::unique_ptr<Storage>(new Backend::ClockCache(size)); }},
+        {"tinylfu", [](std::size_t size) { return std::unique_ptr<Storage>(new Backend::TinyLFU(size)); }},
+    };
+
+    for (auto &e : engines) {
+        auto storage = e.second(budget);
+        Replay(e.first, *storage, trace);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t entry_size = Key(0).size() + value_size;
+
+    auto zipf = ZipfTrace(keys_count, ops_count, 0.99, 42);
+    for (std::size_t percent : {1, 10, 30}) {
+        char title[64];
+        std::snprintf(title, sizeof(title), "zipf 0.99, cache for %zu%% of keys", percent);
+        Run(title, zipf, keys_count * entry_size * percent / 100);
+    }
+
+    auto scan = ScanTrace(zipf, keys_count, 500000);
+    for (std::size_t percent : {1, 10, 30}) {
+        char title[64];
+        std::snprintf(title, sizeof(title), "zipf 0.99 + full scans, cache for %zu%% of keys", percent);
+        Run(title, scan, keys_count * entry_size * percent / 100);
+    }
+    return 0;
+}
@@ -1,6 +1,7 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <memory>
 #include <string>
 
 namespace Afina {
@@ -84,6 +85,28 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value)  = 0; // const
+
+    /**
+     * Retrive value for the given key without copying it
+     * If there is an association for the given key then method points output
+     * parameter to the value buffer and returns true. Buffer is immutable and
+     * stays valid as long as caller holds the pointer, even if association
+     * gets updated or deleted meanwhile
+     *
+     * Default implementation copies value once with Get, storages keeping
+     * values in shared buffers override it
+     *
+     * @param key to retrive value for
+     * @param value output parameter to point to the value
+     */
+    virtual bool GetView(const std::string &key, std::shared_ptr<const std::string> &value) {
+        std::shared_ptr<std::string> copy = std::make_shared<std::string>();
+        if (!Get(key, *copy)) {
+            return false;
+        }
+        value = std::move(copy);
+        return true;
+    }
 };
 
 } // namespace Afina
@@ -0,0 +1,55 @@
+#ifndef AFINA_ALLOCATOR_ADAPTER_H
+#define AFINA_ALLOCATOR_ADAPTER_H
+
+#include <cstddef>
+#include <new>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Simple.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Allocator for C++ containers on top of Simple
+ * Containers keep raw pointers, so every block is pinned and never moved by defragmentation. All copies and
+ * rebinds share the same Simple instance, it must outlive containers using it.
+ *
+ * std::bad_alloc is thrown once wrapped area has no space left, as containers expect.
+ */
+template <typename T> class Adapter {
+public:
+    typedef T value_type;
+
+    Adapter(Simple &allocator) noexcept : _allocator(&allocator) {}
+
+    template <typename U> Adapter(const Adapter<U> &other) noexcept : _allocator(other._allocator) {}
+
+    T *allocate(std::size_t n) {
+        try {
+            return static_cast<T *>(_allocator->alloc_pinned(n * sizeof(T)));
+        } catch (AllocError &) {
+            throw std::bad_alloc();
+        }
+    }
+
+    void deallocate(T *p, std::size_t) { _allocator->free_pinned(p); }
+
+    template <typename U> bool operator==(const Adapter<U> &other) const noexcept {
+        return _allocator == other._allocator;
+    }
+
+    template <typename U> bool operator!=(const Adapter<U> &other) const noexcept {
+        return _allocator != other._allocator;
+    }
+
+private:
+    template <typename U> friend class Adapter;
+
+    Simple *_allocator;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_ADAPTER_H
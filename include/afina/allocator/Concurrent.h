@@ -0,0 +1,79 @@
+#ifndef AFINA_ALLOCATOR_CONCURRENT_H
+#define AFINA_ALLOCATOR_CONCURRENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Multi-threaded slab allocator
+ * Layered the same way as tarantool's small: arena of slabs shared by all threads, lock-free, then thread local
+ * cache of empty slabs, then thread local mempool per size class. Allocation and free of object by the thread that
+ * allocated it touch thread local state only, shared arena is visited to refill or drain the cache. Object freed by
+ * other thread is handed back to its owner pool through lock-free list.
+ *
+ * Thread gets its local state on the first call and gives it back on exit, state is reused by threads started
+ * later together with the slabs it holds. Requests larger than max_size() and requests arena has no memory for
+ * are served by malloc.
+ *
+ * Instance must outlive all the calls to it, memory is released once instance and all the threads that used it
+ * are gone.
+ */
+class Concurrent {
+public:
+    /**
+     * @param size size of the area to reserve for slabs
+     * @param slab_size size of a single slab, must be power of 2
+     */
+    Concurrent(size_t size, size_t slab_size = 1 << 16);
+    ~Concurrent();
+
+    Concurrent(const Concurrent &) = delete;
+    Concurrent &operator=(const Concurrent &) = delete;
+
+    /**
+     * Returns block of at least N bytes aligned as malloc does
+     *
+     * @param N size_t
+     */
+    void *alloc(size_t N);
+
+    /**
+     * Returns block allocated by this instance, could be called by any thread. Freeing nullptr does nothing
+     *
+     * @param p void*
+     */
+    void free(void *p);
+
+    /**
+     * Largest block served from slabs
+     */
+    size_t max_size() const;
+
+    /**
+     * Arena usage
+     */
+    std::string dump() const;
+
+private:
+    struct state;
+    struct local;
+    struct bindings;
+
+    // Local state of the calling thread, registered on the first call
+    local *current() const;
+
+    // Per thread list of instance id to local state pairs
+    static thread_local bindings _bindings;
+
+    std::shared_ptr<state> _state;
+    const uint64_t _id;
+};
+
+} // namespace Allocator
+} // namespace Afina
+#endif // AFINA_ALLOCATOR_CONCURRENT_H
@@ -7,6 +7,13 @@ namespace Allocator {
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * Handle to the block allocated by Simple. It doesn't point to the block directly, but to the descriptor slot in
+ * allocator's indirection table, so block could be moved by Simple::defrag and Simple::realloc while handle stays
+ * valid. Raw address returned by get() is valid only until the next call to allocator.
+ *
+ * Copies of the handle share the same descriptor, once block is freed through one of them the others are dangling.
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +24,15 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const { return _desc == nullptr ? nullptr : *_desc; }
+
+private:
+    friend class Simple;
+
+    explicit Pointer(void **desc);
+
+    // Descriptor slot holding current address of the block, nullptr for empty handle
+    void **_desc;
 };
 
 } // namespace Allocator
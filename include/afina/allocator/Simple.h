@@ -3,6 +3,7 @@
 
 #include <string>
 #include <cstddef>
+#include <cstdint>
 
 namespace Afina {
 namespace Allocator {
@@ -15,47 +16,122 @@ class Pointer;
  * Wraps given memory area and provides defagmentation allocator interface on
  * the top of it.
  *
+ * Blocks grow from the start of the area, each one prefixed by a small header, while table of descriptors grows
+ * down from the end of it. Pointer refers to descriptor rather than to the block, so blocks can be slided together
+ * by defrag() and all the free space gathered at the top.
+ *
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * Blocks could also be pinned, such a block is addressed by raw pointer and never moved. Defragmentation leaves
+ * holes in front of pinned blocks. See Adapter for usage with C++ containers.
+ *
+ * That is NOT thread safe implementaiton!!
  */
-// TODO: Implements interface to allow usage as C++ allocators
 class Simple {
 public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes. Free block that fits is reused if there is one, otherwise block is cut
+     * from the top of the area. If there is no room left there but free blocks would make enough space allocator
+     * defragments itself first. Throws AllocError with NoMemory type if the total free space isn't enough
+     *
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Changes size of the block keeping its content up to the smaller of sizes. Block is resized in place when
+     * possible, otherwise it is moved and p keeps pointing to it. Empty p is allocated from scratch. Throws
+     * AllocError with NoMemory type if nothing fits, original block is untouched in that case
+     *
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Releases block and its descriptor, p becomes empty. Freeing empty pointer does nothing
+     *
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes that is never moved, so raw pointer to it stays valid until
+     * free_pinned(). Throws AllocError with NoMemory type if nothing fits
+     *
+     * @param N size_t
+     */
+    void *alloc_pinned(size_t N);
+
+    /**
+     * Releases pinned block. Throws AllocError with InvalidFree type if p isn't a pinned block, freeing nullptr
+     * does nothing
+     *
+     * @param p void*
+     */
+    void free_pinned(void *p);
+
+    /**
+     * Moves used blocks down as far as pinned ones allow, so all free space becomes one block at the top if there
+     * are no pinned blocks. Raw addresses obtained from pointers before the call are invalid after it
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Layout of the area, one line per block
      */
     std::string dump() const;
 
 private:
+    struct block_t;
+
+    // Finds block of at least N bytes, defragmenting area if necessary. Returns nullptr if there is no space
+    block_t *place(size_t N);
+
+    // Free block of at least N bytes below the top or nullptr, the smallest bin that fits is used
+    block_t *first_fit(size_t N);
+
+    // Cuts tail of the used block off if it is large enough to become a separate free block
+    void split(block_t *block, size_t N);
+
+    // Merges free blocks following the free one into it, then gives it back to the top if block is the last one
+    // or puts into a bin otherwise
+    void merge(block_t *block);
+
+    // Free blocks too small to hold bin links aren't binned, they are only merged by neighbours
+    void link(block_t *block);
+    void unlink(block_t *block);
+
+    // Returns unused descriptor slot or nullptr if table can't grow even after defragmentation
+    void **take_descriptor();
+
     void *_base;
     const size_t _base_len;
+
+    // End of the last block, area between it and the table is free
+    char *_top;
+
+    // Total size of free blocks below the top, headers included
+    size_t _free_bytes;
+
+    // Number of pinned blocks
+    size_t _pinned;
+
+    // Free blocks below the top by size: exact sizes for small blocks, powers of 2 for large ones. Bit is set
+    // for every non empty bin
+    static const size_t bins_count = 128;
+    block_t *_bins[bins_count];
+    uint64_t _bins_used[bins_count / 64];
+
+    // Lowest descriptor slot, table occupies area up to the end of the wrapped memory
+    void **_table;
+
+    // Unused descriptor slots linked through themselves
+    void **_free_desc;
 };
 
 } // namespace Allocator
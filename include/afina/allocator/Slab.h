@@ -0,0 +1,103 @@
+#ifndef AFINA_ALLOCATOR_SLAB_H
+#define AFINA_ALLOCATOR_SLAB_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Slab allocator
+ * Wraps given memory area, cuts it into equal slabs and serves fixed size chunks out of them. Chunk sizes form
+ * geometric progression of size classes, each slab once given to a class is cut into chunks of that class and
+ * stays with it forever. There is no per chunk header and no fragmentation beyond rounding up to the class size.
+ *
+ * Allocator instance doesn't take ownership of wrapped memmory and do not delete it on destruction. Memory of
+ * the area is touched only once a chunk is served out of it, so untouched tail of area costs no RSS.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class Slab {
+public:
+    /**
+     * @param base start of the memory area
+     * @param size size of the area, only whole slabs are used
+     * @param slab_size size of a single slab, also the largest chunk size
+     * @param factor ratio between neighbour size classes
+     */
+    Slab(void *base, const size_t size, const size_t slab_size = 1 << 20, const double factor = 1.25);
+
+    /**
+     * Returns chunk of the smallest class fitting N bytes. If class has no free chunks and there are no free slabs
+     * left returns nullptr, caller should free some chunk of the same class and try again
+     *
+     * @param N size_t
+     */
+    void *alloc(size_t N);
+
+    /**
+     * Returns chunk back to its class. Throws AllocError if pointer wasn't allocated by this instance
+     *
+     * @param p void*
+     */
+    void free(void *p);
+
+    /**
+     * Class number that serves allocations of N bytes, -1 if N is larger then any chunk
+     *
+     * @param N size_t
+     */
+    int size_class(size_t N) const;
+
+    /**
+     * Class number of the allocated chunk
+     *
+     * @param p void*
+     */
+    int size_class(void *p) const;
+
+    /**
+     * Number of size classes
+     */
+    inline size_t classes() const { return _classes.size(); }
+
+    /**
+     * Largest size could be allocated
+     */
+    inline size_t max_size() const { return _classes.empty() ? 0 : _classes.back().chunk_size; }
+
+    /**
+     * Per class usage statistics, one line per class that has slabs
+     */
+    std::string dump() const;
+
+private:
+    struct size_class_t {
+        size_t chunk_size;
+
+        // Chunks returned by free(), linked through first word of the chunk
+        void *free_list;
+
+        // Part of the last slab that hasn't been cut into chunks yet
+        char *carve;
+        char *carve_end;
+
+        size_t slabs;
+        size_t used;
+    };
+
+    char *_base;
+    const size_t _slab_size;
+
+    // Slabs that have been given to classes so far and owner class of each
+    size_t _slabs_total;
+    std::vector<int> _slab_owner;
+
+    std::vector<size_class_t> _classes;
+};
+
+} // namespace Allocator
+} // namespace Afina
+#endif // AFINA_ALLOCATOR_SLAB_H
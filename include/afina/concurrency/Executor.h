@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -58,13 +59,13 @@ namespace Concurrency {
             auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
 
             std::unique_lock<std::mutex> lock(this->_mutex);
-            if (_state != State::kRun || _tasks.size() >= _high_watermark) {
+            if (_state != State::kRun || _tasks.size() >= _max_queue_size) {
                 return false;
             }
 
-            // Enqueue new task
+            // Enqueue new task, pool grows only when free threads are not enough to take all of them
             _tasks.push_back(exec);
-            if (_free_threads == 0 && _threads.size() < _high_watermark) {
+            if (_tasks.size() > std::size_t(_free_threads) && _curr_threads < _high_watermark) {
                 _curr_threads++;
                 _add_thread();
             }
@@ -94,11 +95,10 @@ namespace Concurrency {
      */
         std::condition_variable empty_condition;
 
-        std::condition_variable _stop_cv;
         /**
-     * Vector of actual threads that perorm execution
+     * Conditional variable to await the last thread to exit on stop
      */
-        std::vector<std::thread> _threads;
+        std::condition_variable _stop_cv;
 
         /**
      * Task queue
@@ -111,10 +111,26 @@ namespace Concurrency {
         State _state;
 
         std::string _name;
+
+        /**
+     * Threads kept alive even when there is nothing to do and upper limit of threads
+     */
         int _low_watermark;
         int _high_watermark;
-        int _max_queue_size;
+
+        /**
+     * Tasks waiting for a free thread, Execute fails once queue is that long
+     */
+        std::size_t _max_queue_size;
+
+        /**
+     * Milliseconds thread above low watermark waits for a task before it exits
+     */
         int _idle_time;
+
+        /**
+     * Threads waiting for tasks and all running threads
+     */
         int _free_threads;
         int _curr_threads;
 
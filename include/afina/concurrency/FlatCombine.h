@@ -1,13 +1,209 @@
 #ifndef AFINA_CONCURRENCY_FLAT_COMBINE_H
 #define AFINA_CONCURRENCY_FLAT_COMBINE_H
 
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
 namespace Afina {
 namespace Concurrency {
 
-    template <typename Op>
-    class FlatCombine {
+/**
+ * # Flat combining
+ * Serializes operations on a structure without lock handoff between threads. Each thread publishes pointer to its
+ * operation in a slot and spins; the one that manages to take the combiner lock scans all slots and executes every
+ * pending operation in a single batch, others find theirs done without ever touching the structure. So the
+ * structure stays in the cache of one core and contended lock is taken once per batch instead of once per call.
+ *
+ * Slots belong to the combiner, thread owns one only for the duration of its call. Each thread has a home slot
+ * and probes next ones if home is busy, so the number of slots bounds only how many operations make one batch.
+ * Operation is executed by some thread, maybe not the calling one.
+ *
+ * If executor throws, every operation of that batch is considered failed and the exception is rethrown by Apply
+ * of each of them. Executor which knows what exactly has failed should report it through operations instead
+ */
+template <typename Op> class FlatCombine {
+public:
+    /**
+     * Executes batch of operations, called by combiner with the lock held
+     */
+    using Executor = std::function<void(Op *const *ops, std::size_t count)>;
+
+    /**
+     * @param execute function applying operations to the structure
+     * @param slots how many operations could be published at once
+     */
+    explicit FlatCombine(Executor execute, std::size_t slots = 64)
+        : _execute(std::move(execute)), _slots(slots == 0 ? 1 : slots), _used(0), _locked(false), _batches(0),
+          _ops(0) {
+        _batch.reserve(_slots.size());
+        _ops_batch.reserve(_slots.size());
+    }
+
+    FlatCombine(const FlatCombine &) = delete;
+
+    /**
+     * Publishes operation and returns once it is executed, either by the calling thread or by current combiner.
+     * Rethrows exception executor has thrown on the batch operation was in
+     */
+    void Apply(Op &op) {
+        slot &s = Acquire();
+        s.op = &op;
+        s.state.store(Pending, std::memory_order_release);
+
+        for (std::size_t spins = 0; s.state.load(std::memory_order_acquire) != Done; spins++) {
+            if (TryLock()) {
+                combiner_lock lock(*this);
+                Combine();
+            } else if (spins % 64 == 63) {
+                // Combiner might have been preempted, let it go on
+                std::this_thread::yield();
+            }
+        }
+
+        std::exception_ptr error = std::move(s.error);
+        s.error = nullptr;
+        s.state.store(Free, std::memory_order_release);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * Number of batches executed and operations in them, the ratio is the average batch size
+     */
+    std::size_t Batches() const { return _batches.load(std::memory_order_relaxed); }
+    std::size_t Operations() const { return _ops.load(std::memory_order_relaxed); }
+
+private:
+    // Slot is taken by thread, holds published operation, holds executed operation
+    static const int Free = 0;
+    static const int Claimed = 1;
+    static const int Pending = 2;
+    static const int Done = 3;
+
+    // Slots are padded by hand rather than aligned: C++11 allocation doesn't honour alignment above the one of
+    // max_align_t, so neither vector of slots nor heap allocated FlatCombine would get it
+    static const std::size_t cache_line = 64;
+
+    // Op pointer is written by owner before Pending and read by combiner only after it sees Pending, error is
+    // set by combiner before Done and taken by owner after it sees Done
+    struct slot {
+        slot() : state(Free), op(nullptr) {}
+
+        std::atomic<int> state;
+        Op *op;
+        std::exception_ptr error;
+
+        // Keeps next slot off the cache line of this one
+        char pad[cache_line];
     };
 
+    // Takes combiner lock acquired by TryLock and releases it however combining ends
+    class combiner_lock {
+    public:
+        explicit combiner_lock(FlatCombine &owner) : _owner(owner) {}
+        ~combiner_lock() { _owner.Unlock(); }
+
+    private:
+        FlatCombine &_owner;
+    };
+
+    // Claims a free slot starting from the home one of calling thread
+    slot &Acquire() {
+        std::size_t i = Home() % _slots.size();
+        for (std::size_t spins = 0;; spins++) {
+            int expected = Free;
+            if (_slots[i].state.load(std::memory_order_relaxed) == Free &&
+                _slots[i].state.compare_exchange_strong(expected, Claimed, std::memory_order_acquire)) {
+                // Make sure combiner scans this far
+                std::size_t used = _used.load(std::memory_order_relaxed);
+                while (used <= i && !_used.compare_exchange_weak(used, i + 1, std::memory_order_relaxed)) {
+                }
+                return _slots[i];
+            }
+            i = (i + 1) % _slots.size();
+            if (spins % _slots.size() == _slots.size() - 1) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Home slot: threads get consecutive numbers in order of their first call
+    static std::size_t Home() {
+        static std::atomic<std::size_t> threads(0);
+        static thread_local std::size_t home = threads.fetch_add(1, std::memory_order_relaxed);
+        return home;
+    }
+
+    bool TryLock() {
+        return !_locked.load(std::memory_order_relaxed) && !_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void Unlock() { _locked.store(false, std::memory_order_release); }
+
+    // Executes everything published so far, lock must be held. Scans again while other threads keep publishing,
+    // but not for too long, combiner has own call to return from
+    void Combine() {
+        for (int pass = 0; pass < 4; pass++) {
+            _batch.clear();
+            std::size_t used = _used.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < used; i++) {
+                if (_slots[i].state.load(std::memory_order_acquire) == Pending) {
+                    _batch.push_back(&_slots[i]);
+                }
+            }
+            if (_batch.empty()) {
+                return;
+            }
+
+            _ops_batch.clear();
+            for (slot *s : _batch) {
+                _ops_batch.push_back(s->op);
+            }
+            std::exception_ptr error;
+            try {
+                _execute(_ops_batch.data(), _ops_batch.size());
+            } catch (...) {
+                error = std::current_exception();
+            }
+            for (slot *s : _batch) {
+                s->error = error;
+                s->state.store(Done, std::memory_order_release);
+            }
+
+            _batches.fetch_add(1, std::memory_order_relaxed);
+            _ops.fetch_add(_batch.size(), std::memory_order_relaxed);
+            if (_batch.size() == 1) {
+                // Nobody else around
+                return;
+            }
+        }
+    }
+
+    Executor _execute;
+    std::vector<slot> _slots;
+
+    // Slots past this one have never been claimed, so combiner doesn't look there
+    std::atomic<std::size_t> _used;
+
+    // Combiner lock, on its own line so spinning on it doesn't hit any slot or counter
+    char _pad_before[cache_line];
+    std::atomic<bool> _locked;
+    char _pad_after[cache_line];
+
+    // Scratch space of combiner
+    std::vector<slot *> _batch;
+    std::vector<Op *> _ops_batch;
+
+    std::atomic<std::size_t> _batches;
+    std::atomic<std::size_t> _ops;
+};
+
 } // namespace Concurrency
 } // namespace Afina
 
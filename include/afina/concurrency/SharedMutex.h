@@ -0,0 +1,67 @@
+#ifndef AFINA_CONCURRENCY_SHARED_MUTEX_H
+#define AFINA_CONCURRENCY_SHARED_MUTEX_H
+
+#include <pthread.h>
+#include <stdexcept>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Reader-writer lock
+ * Mutex supporting both exclusive (write) and shared (read) ownership, std::shared_mutex is C++17 only. Writers
+ * are preferred, so a stream of readers can't starve them.
+ *
+ * Satisfies Lockable, so exclusive ownership could be taken by std::lock_guard/std::unique_lock, shared one
+ * by SharedLock below
+ */
+class SharedMutex {
+public:
+    SharedMutex() {
+        pthread_rwlockattr_t attr;
+        pthread_rwlockattr_init(&attr);
+        pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+        int err = pthread_rwlock_init(&_lock, &attr);
+        pthread_rwlockattr_destroy(&attr);
+        if (err != 0) {
+            throw std::runtime_error("Failed to create rwlock");
+        }
+    }
+    ~SharedMutex() { pthread_rwlock_destroy(&_lock); }
+
+    SharedMutex(const SharedMutex &) = delete;
+    SharedMutex &operator=(const SharedMutex &) = delete;
+
+    // Exclusive ownership
+    void lock() { pthread_rwlock_wrlock(&_lock); }
+    bool try_lock() { return pthread_rwlock_trywrlock(&_lock) == 0; }
+    void unlock() { pthread_rwlock_unlock(&_lock); }
+
+    // Shared ownership
+    void lock_shared() { pthread_rwlock_rdlock(&_lock); }
+    bool try_lock_shared() { return pthread_rwlock_tryrdlock(&_lock) == 0; }
+    void unlock_shared() { pthread_rwlock_unlock(&_lock); }
+
+private:
+    pthread_rwlock_t _lock;
+};
+
+/**
+ * RAII wrapper taking shared ownership of the mutex for the scope
+ */
+template <typename Mutex> class SharedLock {
+public:
+    explicit SharedLock(Mutex &m) : _mutex(m) { _mutex.lock_shared(); }
+    ~SharedLock() { _mutex.unlock_shared(); }
+
+    SharedLock(const SharedLock &) = delete;
+    SharedLock &operator=(const SharedLock &) = delete;
+
+private:
+    Mutex &_mutex;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SHARED_MUTEX_H
@@ -0,0 +1,144 @@
+#ifndef AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
+#define AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Chase-Lev work stealing deque
+ * Owner thread pushes and pops items at the bottom without locks, any other thread steals them from the top. The
+ * only contended operation is taking the very last item, owner and thieves race for it with CAS on top. Memory
+ * orders follow "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.).
+ *
+ * Ring buffer doubles once full, old ones are kept until deque is destroyed since thief might still read from
+ * them. Deque keeps pointers and doesn't own items
+ */
+template <typename T> class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(std::size_t capacity = 64) : _top(0), _bottom(0) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _array.store(new Array(size), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+
+    ~WorkStealingDeque() {
+        delete _array.load(std::memory_order_relaxed);
+        for (Array *a : _retired) {
+            delete a;
+        }
+    }
+
+    /**
+     * Adds item to the bottom, owner only
+     */
+    void Push(T *item) {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_acquire);
+        Array *a = _array.load(std::memory_order_relaxed);
+        if (b - t > int64_t(a->mask)) {
+            a = Grow(a, t, b);
+        }
+        a->Put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Takes the most recently pushed item, owner only. Returns nullptr if deque is empty
+     */
+    T *Pop() {
+        int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = _array.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty already
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *item = a->Get(b);
+        if (t == b) {
+            // Last one, thieves might be after it as well
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * Takes the oldest item, any thread. Returns nullptr if deque is empty or other thread has taken it first
+     */
+    T *Steal() {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Array *a = _array.load(std::memory_order_acquire);
+        T *item = a->Get(t);
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /**
+     * Number of items, could be stale by the time it returns unless called by owner with no thieves around
+     */
+    std::size_t Size() const {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_relaxed);
+        return b > t ? std::size_t(b - t) : 0;
+    }
+
+private:
+    struct Array {
+        explicit Array(std::size_t size) : mask(size - 1), items(new std::atomic<T *>[size]) {}
+        ~Array() { delete[] items; }
+
+        T *Get(int64_t i) const { return items[i & mask].load(std::memory_order_relaxed); }
+        void Put(int64_t i, T *item) { items[i & mask].store(item, std::memory_order_relaxed); }
+
+        std::size_t mask;
+        std::atomic<T *> *items;
+    };
+
+    // Copies live items into twice as large buffer, owner only
+    Array *Grow(Array *a, int64_t t, int64_t b) {
+        Array *bigger = new Array((a->mask + 1) * 2);
+        for (int64_t i = t; i < b; i++) {
+            bigger->Put(i, a->Get(i));
+        }
+        _retired.push_back(a);
+        _array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    std::atomic<int64_t> _top;
+    std::atomic<int64_t> _bottom;
+    std::atomic<Array *> _array;
+
+    // Buffers replaced by larger ones
+    std::vector<Array *> _retired;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
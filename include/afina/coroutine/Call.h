@@ -0,0 +1,42 @@
+#ifndef AFINA_COROUTINE_CALL_H
+#define AFINA_COROUTINE_CALL_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Function to be called in coroutine along with its arguments
+ * Engines with dedicated stacks can't keep arguments on the stack of the caller, so they are bound in advance
+ */
+class Call {
+public:
+    virtual ~Call() {}
+    virtual void operator()() = 0;
+};
+
+template <typename... Ta> class BoundCall : public Call {
+public:
+    BoundCall(void (*func)(Ta...), Ta &&... args) : _func(func), _args(std::forward<Ta>(args)...) {}
+
+    void operator()() override { Apply(typename MakeIndices<sizeof...(Ta)>::type()); }
+
+private:
+    template <std::size_t... I> struct Indices {};
+    template <std::size_t N, std::size_t... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+    template <std::size_t... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+    template <std::size_t... I> void Apply(Indices<I...>) { _func(std::forward<Ta>(std::get<I>(_args))...); }
+
+    // Reference arguments are kept as references, the rest are moved in
+    void (*_func)(Ta...);
+    std::tuple<Ta...> _args;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_CALL_H
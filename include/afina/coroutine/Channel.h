@@ -0,0 +1,102 @@
+#ifndef AFINA_COROUTINE_CHANNEL_H
+#define AFINA_COROUTINE_CHANNEL_H
+
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+#include <afina/coroutine/Engine.h>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Bounded channel between coroutines of one engine
+ * Sender blocks while channel is full, receiver blocks while it is empty. Once closed channel refuses new values,
+ * but the ones already sent could still be received. Capacity must be positive. Not threadsafe, just like engine
+ */
+template <typename T> class Channel {
+public:
+    Channel(Engine &engine, std::size_t capacity) : _engine(engine), _capacity(capacity), _closed(false) {}
+    Channel(const Channel &) = delete;
+
+    /**
+     * Puts value into channel, blocks current routine while channel is full. Returns false if channel is closed
+     */
+    bool send(T value) {
+        while (!_closed && _values.size() >= _capacity) {
+            Wait(_senders);
+        }
+        if (_closed) {
+            return false;
+        }
+
+        _values.push_back(std::move(value));
+        Wake(_receivers);
+        return true;
+    }
+
+    /**
+     * Takes the oldest value out of channel, blocks current routine while channel is empty. Returns false once
+     * channel is closed and there is nothing left
+     */
+    bool recv(T &value) {
+        while (!_closed && _values.empty()) {
+            Wait(_receivers);
+        }
+        if (_values.empty()) {
+            return false;
+        }
+
+        value = std::move(_values.front());
+        _values.pop_front();
+        Wake(_senders);
+        return true;
+    }
+
+    /**
+     * Refuses further values and wakes up everyone waiting
+     */
+    void close() {
+        _closed = true;
+        while (!_senders.empty()) {
+            Wake(_senders);
+        }
+        while (!_receivers.empty()) {
+            Wake(_receivers);
+        }
+    }
+
+    bool closed() const { return _closed; }
+
+    std::size_t size() const { return _values.size(); }
+
+private:
+    // Blocks current routine until Wake picks it from the queue
+    void Wait(std::deque<void *> &queue) {
+        queue.push_back(_engine.current());
+        _engine.block();
+    }
+
+    void Wake(std::deque<void *> &queue) {
+        if (!queue.empty()) {
+            _engine.unblock(queue.front());
+            queue.pop_front();
+        }
+    }
+
+    Engine &_engine;
+    std::size_t _capacity;
+    bool _closed;
+
+    std::deque<T> _values;
+
+    // Routines blocked on full and empty channel, in order of arrival
+    std::deque<void *> _senders;
+    std::deque<void *> _receivers;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_CHANNEL_H
@@ -1,18 +1,26 @@
 #ifndef AFINA_COROUTINE_ENGINE_H
 #define AFINA_COROUTINE_ENGINE_H
 
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <queue>
 #include <setjmp.h>
 #include <tuple>
+#include <vector>
+
+#include <afina/coroutine/Pool.h>
 
 namespace Afina {
 namespace Coroutine {
 
 /**
  * # Entry point of coroutine library
- * Allows to run coroutine and schedule its execution. Not threadsafe
+ * Allows to run coroutine and schedule its execution. Routine could block itself until someone unblocks it, its
+ * timer fires or descriptor it waits for gets ready. Once nothing is alive engine sleeps in epoll_wait until the
+ * nearest of those. Not threadsafe
  */
 class Engine final {
 private:
@@ -37,8 +45,33 @@ private:
         // To include routine in the different lists, such as "alive", "blocked", e.t.c
         struct context *prev = nullptr;
         struct context *next = nullptr;
+
+        // Whether routine is in "blocked" list rather than "alive" one
+        bool blocked = false;
+
+        // Pending timer to unblock routine, 0 if none
+        uint64_t timer = 0;
+
+        // Timers in the heap pointing to this context, stale ones included. Context can't be freed until they
+        // are gone, it is left as zombie instead
+        uint32_t timers_pending = 0;
+        bool zombie = false;
+
+        // Events of the descriptor routine waits for, 0 until it gets ready
+        uint32_t events = 0;
     } context;
 
+    /**
+     * Routine to be unblocked once deadline passes. Timer is stale if routine's one has changed since
+     */
+    struct timer {
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t id;
+        context *routine;
+
+        bool operator>(const timer &other) const { return deadline > other.deadline; }
+    };
+
     /**
      * Where coroutines stack begins
      */
@@ -54,11 +87,38 @@ private:
      */
     context *alive;
 
+    /**
+     * List of routines waiting for unblock
+     */
+    context *blocked;
+
     /**
      * Context to be returned finally
      */
     context *idle_ctx;
 
+    /**
+     * Timers of sleeping routines, the nearest on top. Timer of routine unblocked earlier stays until it is due
+     */
+    std::priority_queue<timer, std::vector<timer>, std::greater<timer>> timers;
+    uint64_t last_timer;
+
+    /**
+     * Descriptors routines wait for, created on first wait
+     */
+    int epoll_fd;
+    std::size_t io_waiters;
+
+    /**
+     * When ready descriptors and timers were checked last time
+     */
+    std::chrono::steady_clock::time_point last_poll;
+
+    /**
+     * Finished routines, new ones reuse their contexts along with stack copy buffers
+     */
+    Pool<context> pool;
+
 protected:
     /**
      * Save stack of the current coroutine in the given context
@@ -75,10 +135,61 @@ protected:
      */
     // void Enter(context& ctx);
 
+    /**
+     * Context for new routine, recycled one if pool has any
+     */
+    context *Acquire();
+
+    /**
+     * Returns context of finished routine into the pool, or frees it if pool is full
+     */
+    void Release(context *ctx);
+
+    /**
+     * Frees context along with its stack copy buffer
+     */
+    static void Free(context *ctx);
+
+    /**
+     * Double linked list helpers
+     */
+    static void Link(context *&list, context *ctx);
+    static void Unlink(context *&list, context *ctx);
+
+    /**
+     * Idle part of the engine, runs on behalf of the caller of start: passes control to alive routines and
+     * sleeps in Poll while there are none. Returns once nothing is alive and nothing could unblock the rest
+     */
+    void Schedule();
+
+    /**
+     * Unblocks routines whose descriptors are ready or timers are due. Waits for them up to timeout milliseconds
+     * if there are none yet, -1 means until the nearest timer. Returns false if nothing could ever unblock routine
+     */
+    bool Poll(int timeout);
+
+    /**
+     * Sets timer to unblock current routine
+     */
+    void Timer(std::chrono::milliseconds timeout);
+
 public:
-    Engine() : StackBottom(0), cur_routine(nullptr), alive(nullptr) {}
+    static const std::size_t default_pool_size = 64;
+
+    /**
+     * @param pool_size how many contexts of finished routines to keep for reuse
+     */
+    explicit Engine(std::size_t pool_size = default_pool_size)
+        : StackBottom(0), cur_routine(nullptr), alive(nullptr), blocked(nullptr), idle_ctx(nullptr), last_timer(0),
+          epoll_fd(-1), io_waiters(0), pool(pool_size) {}
     Engine(Engine &&) = delete;
     Engine(const Engine &) = delete;
+    ~Engine();
+
+    /**
+     * Hits and misses of the context pool
+     */
+    const PoolStats &pool_stats() const { return pool.Stats(); }
 
     /**
      * Gives up current routine execution and let engine to schedule other one. It is not defined when
@@ -99,12 +210,40 @@ public:
      */
     void sched(void *routine);
 
+    /**
+     * Routine executing right now, nullptr outside of coroutines
+     */
+    void *current() const;
+
+    /**
+     * Moves routine to the blocked list, it won't be scheduled until unblocked. If routine is not specified
+     * current one is blocked and control is passed to other alive routine
+     */
+    void block(void *routine = nullptr);
+
+    /**
+     * Makes blocked routine alive again. Control isn't transferred, routine gets it the usual way
+     */
+    void unblock(void *routine);
+
+    /**
+     * Blocks current routine for at least given time
+     */
+    void sleep_for(std::chrono::milliseconds timeout);
+
+    /**
+     * Blocks current routine until descriptor gets any of given epoll events or timeout passes, negative timeout
+     * means no timeout. Returns events happened, 0 on timeout or if routine was unblocked by someone else
+     */
+    uint32_t wait(int fd, uint32_t events, std::chrono::milliseconds timeout = std::chrono::milliseconds(-1));
+
     /**
      * Entry point into the engine. Prepare all internal mechanics and starts given function which is
      * considered as main.
      *
      * Once control returns back to caller of start all coroutines are done execution, in other words,
-     * this function doesn't return control until all coroutines are done.
+     * this function doesn't return control until all coroutines are done. The only exception is deadlock: if
+     * remaining routines are blocked and there are neither timers nor descriptors to unblock them, they are dropped.
      *
      * @param pointer to the main coroutine
      * @param arguments to be passed to the main coroutine
@@ -118,14 +257,17 @@ public:
         void *pc = run(main, std::forward<Ta>(args)...);
         idle_ctx = new context();
         if (setjmp(idle_ctx->Environment) > 0) {
-            // Here: correct finish of the coroutine section
-            yield();
+            // Here: some coroutine has finished, keep running the rest until none is alive
+            Schedule();
         } else if (pc != nullptr) {
-            Store(*idle_ctx);
+            cur_routine = idle_ctx;
             sched(pc);
+            Schedule();
         }
 
         // Shutdown runtime
+        cur_routine = nullptr;
+        delete[] std::get<0>(idle_ctx->Stack);
         delete idle_ctx;
         this->StackBottom = 0;
     }
@@ -141,7 +283,7 @@ public:
         }
 
         // New coroutine context that carries around all information enough to call function
-        context *pc = new context();
+        context *pc = Acquire();
 
         // Store current state right here, i.e just before enter new coroutine, later, once it gets scheduled
         // execution starts here. Note that we have to acquire stack of the current function call to ensure
@@ -157,23 +299,11 @@ public:
             // to pass control after that. We never want to go backward by stack as that would mean to go backward in
             // time. Function run() has already return once (when setjmp returns 0), so return second return from run
             // would looks a bit awkward
-            if (pc->prev != nullptr) {
-                pc->prev->next = pc->next;
-            }
-
-            if (pc->next != nullptr) {
-                pc->next->prev = pc->prev;
-            }
-
-            if (alive == cur_routine) {
-                alive = alive->next;
-            }
+            Unlink(alive, pc);
 
             // current coroutine finished, and the pointer is not relevant now
             cur_routine = nullptr;
-            pc->prev = pc->next = nullptr;
-            delete std::get<0>(pc->Stack);
-            delete pc;
+            Release(pc);
 
             // We cannot return here, as this function "returned" once already, so here we must select some other
             // coroutine to run. As current coroutine is completed and can't be scheduled anymore, it is safe to
@@ -187,12 +317,7 @@ public:
         Store(*pc);
 
         // Add routine as alive double-linked list
-        pc->next = alive;
-        alive = pc;
-        if (pc->next != nullptr) {
-            pc->next->prev = pc;
-        }
-
+        Link(alive, pc);
         return pc;
     }
 };
@@ -0,0 +1,50 @@
+#ifndef AFINA_COROUTINE_MUTEX_H
+#define AFINA_COROUTINE_MUTEX_H
+
+#include <deque>
+
+#include <afina/coroutine/Engine.h>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Mutex for coroutines of one engine
+ * Routine that can't take the lock blocks in engine instead of spinning, unlock passes lock to the routine waiting
+ * longest. Lock is owned by routine, not thread, so it works as well with routines switching in the middle of
+ * critical section. Not threadsafe, just like engine
+ */
+class Mutex {
+public:
+    explicit Mutex(Engine &engine) : _engine(engine), _owner(nullptr) {}
+    Mutex(const Mutex &) = delete;
+
+    /**
+     * Takes the lock, blocks current routine until it is released by others
+     */
+    void lock();
+
+    /**
+     * Takes the lock if it is free, never blocks
+     */
+    bool try_lock();
+
+    /**
+     * Releases the lock, the first waiting routine becomes its owner and gets alive
+     */
+    void unlock();
+
+private:
+    Engine &_engine;
+
+    // Routine holding the lock, nullptr if it is free
+    void *_owner;
+
+    // Routines blocked in lock, in order of arrival
+    std::deque<void *> _waiters;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_MUTEX_H
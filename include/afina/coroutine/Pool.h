@@ -0,0 +1,87 @@
+#ifndef AFINA_COROUTINE_POOL_H
+#define AFINA_COROUTINE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * How well engine reuses routines: hit is a routine started on recycled context, miss needed a new one
+ */
+struct PoolStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    // Contexts cached right now
+    std::size_t size = 0;
+};
+
+/**
+ * # Free list of finished coroutine contexts
+ * Keeps up to capacity contexts along with whatever memory they own, so that new routine doesn't have to allocate.
+ * Intrusive: contexts are linked through their own next pointer, pool never allocates. Context that doesn't fit
+ * is returned back to the engine to be freed. Not threadsafe
+ */
+template <typename T> class Pool {
+public:
+    explicit Pool(std::size_t capacity) : _capacity(capacity), _free(nullptr) {}
+    Pool(const Pool &) = delete;
+
+    /**
+     * Returns cached context or nullptr if there is none, either counts in stats
+     */
+    T *Get() {
+        if (_free == nullptr) {
+            _stats.misses++;
+            return nullptr;
+        }
+
+        T *ctx = _free;
+        _free = ctx->next;
+        ctx->next = nullptr;
+        _stats.hits++;
+        _stats.size--;
+        return ctx;
+    }
+
+    /**
+     * Caches finished context, returns false if pool is full already
+     */
+    bool Put(T *ctx) {
+        if (_stats.size >= _capacity) {
+            return false;
+        }
+        ctx->prev = nullptr;
+        ctx->next = _free;
+        _free = ctx;
+        _stats.size++;
+        return true;
+    }
+
+    /**
+     * Removes cached context without counting it, nullptr once pool is empty. Engine uses it to free everything
+     */
+    T *Pop() {
+        T *ctx = _free;
+        if (ctx != nullptr) {
+            _free = ctx->next;
+            ctx->next = nullptr;
+            _stats.size--;
+        }
+        return ctx;
+    }
+
+    const PoolStats &Stats() const { return _stats; }
+
+private:
+    std::size_t _capacity;
+    T *_free;
+    PoolStats _stats;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_POOL_H
@@ -0,0 +1,212 @@
+#ifndef AFINA_COROUTINE_SCHEDULER_H
+#define AFINA_COROUTINE_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <afina/coroutine/Call.h>
+#include <afina/coroutine/Pool.h>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * What scheduler has done since start
+ */
+struct SchedulerStats {
+    // Routines taken from the queue of other worker
+    uint64_t steals = 0;
+
+    // Times routine was resumed on other worker than it was suspended on
+    uint64_t migrations = 0;
+
+    // Routines created, and how many of them got recycled stack
+    uint64_t spawned = 0;
+    PoolStats pool;
+};
+
+/**
+ * # M:N coroutine scheduler
+ * Runs coroutines on a number of threads, each of them is a worker with own run queue. Routines have dedicated
+ * stacks the same way as in StackEngine, so any worker could resume any routine.
+ *
+ * Worker takes routines from its Chase-Lev deque, newest first. Once it is empty worker checks global queue, then
+ * steals the oldest routines of other workers, and sleeps if there is nothing at all. Routine created or unblocked
+ * by a worker gets into the queue of that worker, so it migrates there. Yielded routine goes to the global queue,
+ * otherwise it would be taken back right away; global queue is checked once in a while even if worker has work.
+ *
+ * Routine must not rely on thread locals across switches, it could be resumed by other thread. Exception must
+ * not leave coroutine function
+ */
+class Scheduler final {
+private:
+    /**
+     * Single coroutine: its stack, saved registers and scheduling state. Defined in Scheduler.cpp
+     */
+    struct routine;
+
+    /**
+     * Thread running routines along with its run queue. Defined in Scheduler.cpp
+     */
+    struct worker;
+
+    std::size_t _threads;
+    std::size_t _stack_size;
+    std::size_t _pool_size;
+
+    // Workers of the running start, the first one runs on the thread called start
+    std::vector<std::unique_ptr<worker>> _workers;
+    std::atomic<bool> _running;
+
+    // Routines not yet finished, workers exit once it gets zero
+    std::atomic<std::size_t> _live;
+
+    // Global queue: routines created outside of workers and yielded ones
+    std::mutex _lock;
+    std::deque<routine *> _global;
+    std::atomic<std::size_t> _global_size;
+
+    // Workers having nothing to do wait here
+    std::condition_variable _wakeup;
+    std::atomic<std::size_t> _sleeping;
+
+    std::atomic<uint64_t> _steals;
+    std::atomic<uint64_t> _migrations;
+    std::atomic<uint64_t> _spawned;
+    PoolStats _pool_stats;
+
+protected:
+    /**
+     * Runs workers until all routines are done, main one is the first to execute
+     */
+    void Start(Call *main);
+
+    /**
+     * Creates routine and queues it. Returns nullptr if scheduler isn't started or stack can't be allocated
+     */
+    void *Spawn(Call *body);
+
+    /**
+     * Worker loop: takes routine to run, runs it until it gives control back and does what it asked for
+     */
+    void Run(worker &w);
+
+    /**
+     * Next routine for worker: own queue, global one, other workers. Returns nullptr if there is nothing at all
+     */
+    routine *Next(worker &w);
+
+    /**
+     * Sleeps until some queue gets a routine or the last one finishes
+     */
+    void Park();
+
+    /**
+     * Whether any queue has something, called under _lock by worker going to sleep
+     */
+    bool HasWork();
+
+    /**
+     * Queues ready routine: to the worker of calling thread or the global queue if it is not a worker
+     */
+    void Schedule(routine *r);
+    void ScheduleGlobal(routine *r);
+
+    /**
+     * Wakes up one sleeping worker if there are any
+     */
+    void Notify();
+
+    /**
+     * Switches from current routine to its worker, which then does the given action
+     */
+    void Suspend(int action);
+
+    /**
+     * Worker running on the calling thread, nullptr if thread isn't worker of this scheduler. Has to be called
+     * anew after every switch as routine could be resumed by another thread
+     */
+    worker *Current() const;
+
+    /**
+     * First function executed on routine stack: calls its body, then gives control to worker for the last time
+     */
+    static void Enter(void *r);
+
+public:
+    static const std::size_t default_stack_size = 128 * 1024;
+    static const std::size_t default_pool_size = 64;
+
+    /**
+     * @param threads number of workers, including the thread calling start
+     * @param stack_size usable stack of each coroutine, rounded up to pages
+     * @param pool_size how many stacks of finished routines each worker keeps for reuse
+     */
+    explicit Scheduler(std::size_t threads, std::size_t stack_size = default_stack_size,
+                       std::size_t pool_size = default_pool_size);
+    Scheduler(Scheduler &&) = delete;
+    Scheduler(const Scheduler &) = delete;
+    ~Scheduler();
+
+    /**
+     * Gives up current routine execution, it is resumed once others have got a chance to run
+     */
+    void yield();
+
+    /**
+     * Suspends current routine until someone unblocks it. If unblock comes before routine got suspended, block
+     * returns right away
+     */
+    void block();
+
+    /**
+     * Makes blocked routine ready again. Could be called from any thread, routine gets into the queue of the
+     * calling worker and will be resumed there
+     */
+    void unblock(void *routine);
+
+    /**
+     * Routine executing on the calling thread right now, nullptr outside of coroutines
+     */
+    void *current() const;
+
+    /**
+     * Counters of the last start, or of the running one
+     */
+    SchedulerStats stats() const;
+
+    /**
+     * Entry point into the scheduler. Starts given function as main coroutine, runs workers and doesn't return
+     * control until all coroutines are done execution, blocked ones included. Calling thread serves as one of
+     * the workers
+     *
+     * @param pointer to the main coroutine
+     * @param arguments to be passed to the main coroutine
+     */
+    template <typename... Ta> void start(void (*main)(Ta...), Ta &&... args) {
+        Start(new BoundCall<Ta...>(main, std::forward<Ta>(args)...));
+    }
+
+    /**
+     * Register new coroutine, it will be executed by some worker. Could be called from any thread while scheduler
+     * is running. Returns nullptr if scheduler isn't started or stack can't be allocated
+     */
+    template <typename... Ta> void *run(void (*func)(Ta...), Ta &&... args) {
+        if (!_running.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return Spawn(new BoundCall<Ta...>(func, std::forward<Ta>(args)...));
+    }
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_SCHEDULER_H
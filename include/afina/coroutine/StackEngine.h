@@ -0,0 +1,159 @@
+#ifndef AFINA_COROUTINE_STACK_ENGINE_H
+#define AFINA_COROUTINE_STACK_ENGINE_H
+
+#include <cstddef>
+#include <utility>
+
+#include <afina/coroutine/Call.h>
+#include <afina/coroutine/Pool.h>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Coroutine engine with dedicated stacks
+ * Same API as Engine, but every coroutine runs on its own mmap'ed stack with a guard page below it, so switch
+ * only saves callee-saved registers and moves stack pointer instead of copying stack back and forth. Cost of
+ * switch doesn't depend on how deep coroutine is. On x86-64 switch is a hand written register swap, elsewhere
+ * it falls back to swapcontext.
+ *
+ * Coroutine that overflows its stack hits the guard page and gets SIGSEGV instead of corrupting neighbour memory.
+ * Exception must not leave coroutine function, there is nobody to catch it. Not threadsafe
+ */
+class StackEngine final {
+private:
+    /**
+     * A single coroutine instance: its stack, saved registers and place in the "alive" list. Defined in
+     * StackEngine.cpp as its layout depends on the way contexts are switched
+     */
+    struct context;
+
+    /**
+     * Size of each coroutine stack, guard page is not included
+     */
+    std::size_t _stack_size;
+
+    /**
+     * Context of the thread called start, it keeps running scheduler once main coroutine gives control away
+     */
+    context *idle_ctx;
+
+    /**
+     * Current coroutine
+     */
+    context *cur_routine;
+
+    /**
+     * List of routines ready to be scheduled. Note that suspended routine ends up here as well
+     */
+    context *alive;
+
+    /**
+     * Routine that has finished, but its stack was in use at that moment. Freed by whoever gets control next
+     */
+    context *finished;
+
+    /**
+     * Finished routines, new ones reuse their contexts along with mapped stacks
+     */
+    Pool<context> pool;
+
+    /**
+     * Whether start is in progress, routines can't be created otherwise
+     */
+    bool started;
+
+protected:
+    /**
+     * Takes recycled stack or allocates new one for the body and adds new routine to the alive list. Returns nullptr
+     * if stack can't be allocated
+     */
+    void *Spawn(Call *body);
+
+    /**
+     * Runs scheduler on the thread stack until there are no alive routines
+     */
+    void Loop(void *main);
+
+    /**
+     * Saves registers of the current routine and pass control to the given one
+     */
+    void Switch(context &ctx);
+
+    /**
+     * Releases stack of the routine finished just before control came here
+     */
+    void Reap();
+
+    /**
+     * Returns finished routine into the pool, or unmaps its stack if pool is full
+     */
+    void Release(context *ctx);
+
+    /**
+     * First function executed on new stack: calls routine body, then removes routine and never returns
+     */
+    static void Enter(void *ctx);
+
+public:
+    static const std::size_t default_stack_size = 128 * 1024;
+    static const std::size_t default_pool_size = 64;
+
+    /**
+     * @param stack_size usable stack of each coroutine, rounded up to pages
+     * @param pool_size how many stacks of finished routines to keep for reuse
+     */
+    explicit StackEngine(std::size_t stack_size = default_stack_size, std::size_t pool_size = default_pool_size);
+    StackEngine(StackEngine &&) = delete;
+    StackEngine(const StackEngine &) = delete;
+    ~StackEngine();
+
+    /**
+     * Hits and misses of the stack pool
+     */
+    const PoolStats &pool_stats() const { return pool.Stats(); }
+
+    /**
+     * Gives up current routine execution and let engine to schedule other one. If there are no other
+     * coroutines then execution is transferred back immediately (yield turns to be noop).
+     *
+     * There are no guarantee what coroutine will get execution, it could be caller of the current one or
+     * any other which is ready to run
+     */
+    void yield();
+
+    /**
+     * Suspend current routine and transfers control to the given one, resumes its execution from the point
+     * when it has been suspended previously. If routine is not specified this method has same semantics as yield
+     */
+    void sched(void *routine);
+
+    /**
+     * Entry point into the engine. Starts given function as main coroutine and doesn't return control until
+     * all coroutines are done execution.
+     *
+     * @param pointer to the main coroutine
+     * @param arguments to be passed to the main coroutine
+     */
+    template <typename... Ta> void start(void (*main)(Ta...), Ta &&... args) {
+        started = true;
+        Loop(run(main, std::forward<Ta>(args)...));
+        started = false;
+    }
+
+    /**
+     * Register new coroutine. It won't receive control until scheduled explicitely or implicitly. Returns nullptr
+     * if engine isn't started or stack can't be allocated
+     */
+    template <typename... Ta> void *run(void (*func)(Ta...), Ta &&... args) {
+        if (!started) {
+            return nullptr;
+        }
+        return Spawn(new BoundCall<Ta...>(func, std::forward<Ta>(args)...));
+    }
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_STACK_ENGINE_H
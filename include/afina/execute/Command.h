@@ -1,7 +1,10 @@
 #ifndef AFINA_EXECUTE_COMMAND_H
 #define AFINA_EXECUTE_COMMAND_H
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Afina {
 
@@ -9,16 +12,55 @@ class Storage;
 
 namespace Execute {
 
+/**
+ * # Destination of command responses
+ * Network layer collects responses of pipelined commands here and writes them out together
+ */
+class Output {
+public:
+    virtual ~Output() {}
+
+    /**
+     * Appends copy of the given bytes
+     */
+    virtual void Append(const char *data, std::size_t size) = 0;
+
+    /**
+     * Appends buffer that could be shared with storage, output keeps reference instead of copying it if that pays
+     * off. Buffer must never change
+     */
+    virtual void Append(std::shared_ptr<const std::string> data) = 0;
+};
+
 /**
  *
  *
  */
 class Command {
 public:
+    // Response as a sequence of buffers to be written one after another, buffers could be shared with storage
+    typedef std::vector<std::shared_ptr<const std::string>> Chunks;
+
     Command() {}
     virtual ~Command() {}
 
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Same as above, but response is appended to out as chunks, so commands returning values could refer to
+     * storage buffers instead of copying them. Network layer hands chunks to writev as is.
+     *
+     * Default implementation appends result of the string version as a single chunk
+     */
+    virtual void Execute(Storage &storage, const std::string &args, Chunks &out);
+
+    /**
+     * Same as above, but response is appended to out, so that responses of many commands share memory and could be
+     * written by one call.
+     *
+     * Default implementation appends result of the string version
+     */
+    virtual void Execute(Storage &storage, const std::string &args, Output &out);
 };
 
 } // namespace Execute
@@ -41,6 +41,12 @@ public:
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    // Values go to output as storage buffers, see Storage::GetView
+    void Execute(Storage &storage, const std::string &args, Chunks &out) override;
+
+    // Values go to output as storage buffers as well, header is formatted right into output
+    void Execute(Storage &storage, const std::string &args, Output &out) override;
+
 private:
     std::vector<std::string> _keys;
 };
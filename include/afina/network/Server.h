@@ -11,6 +11,18 @@ class Service;
 }
 namespace Network {
 
+/**
+ * What server has done with connection handed over by the previous process
+ */
+enum class Adoption {
+    // Server can't serve it, caller still owns the socket
+    Refused,
+    // Connection is served now
+    Adopted,
+    // Server took the socket but couldn't serve it and has closed it already
+    Dropped
+};
+
 /**
  * # Network processors coordinator
  * Configure resources for the network processors and coordinates all work
@@ -18,7 +30,7 @@ namespace Network {
 class Server {
 public:
     Server(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-        : pStorage(ps), pLogging(pl) {}
+        : pStorage(ps), pLogging(pl), handoffSocket(-1) {}
     virtual ~Server() {}
 
     /**
@@ -44,6 +56,28 @@ public:
      */
     virtual void Join() = 0;
 
+    /**
+     * Listening sockets of the running server, to be handed over to the new process on restart. Empty if server
+     * can't start on sockets of another process
+     */
+    virtual std::vector<int> Sockets() const { return std::vector<int>(); }
+
+    /**
+     * Gives listening sockets of the previous process, Start uses them instead of opening new ones
+     */
+    void Inherit(std::vector<int> sockets) { inheritedSockets = std::move(sockets); }
+
+    /**
+     * Connections that are idle once server stopped are passed to the new process through the given UNIX socket
+     * rather than closed, so their clients don't notice restart
+     */
+    void HandOver(int socket) { handoffSocket = socket; }
+
+    /**
+     * Serves connection handed over by the previous process. Caller owns the socket only if Refused is returned
+     */
+    virtual Adoption Adopt(int socket) { return Adoption::Refused; }
+
 protected:
     /**
      * Instance of backing storeage on which current server should execute
@@ -55,6 +89,16 @@ protected:
      * Logging service to be used in order to report application progress
      */
     std::shared_ptr<Afina::Logging::Service> pLogging;
+
+    /**
+     * Sockets to listen on instead of new ones, see Inherit
+     */
+    std::vector<int> inheritedSockets;
+
+    /**
+     * Socket to pass idle connections to the new process on stop or -1, see HandOver
+     */
+    int handoffSocket;
 };
 
 } // namespace Network
@@ -0,0 +1,176 @@
+#include <afina/allocator/Concurrent.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "Mempool.h"
+#include "SlabArena.h"
+#include "SlabCache.h"
+
+namespace Afina {
+namespace Allocator {
+
+static const size_t class_step = alignof(std::max_align_t);
+
+// Thread local part: slab cache and mempool per size class, owned by one thread at a time
+struct Concurrent::local {
+    local(SlabArena &arena, const std::vector<size_t> &sizes) : cache(arena), taken(false) {
+        for (auto size : sizes) {
+            pools.emplace_back(new Mempool(cache, size));
+        }
+    }
+
+    SlabCache cache;
+    std::vector<std::unique_ptr<Mempool>> pools;
+    std::atomic<bool> taken;
+};
+
+// Shared part, lives while instance or any thread bound to it does
+struct Concurrent::state {
+    state(size_t size, size_t slab_size) : arena(size, slab_size), alive(true) {}
+
+    SlabArena arena;
+
+    // Object size of each class and class serving every multiple of class_step
+    std::vector<size_t> sizes;
+    std::vector<uint8_t> classes;
+
+    // Local states ever created, they are never deleted before arena so pools could be found by slab
+    std::mutex lock;
+    std::vector<std::unique_ptr<local>> locals;
+
+    std::atomic<bool> alive;
+};
+
+struct Concurrent::bindings {
+    struct binding {
+        uint64_t id;
+        std::shared_ptr<state> shared;
+        local *mine;
+    };
+
+    ~bindings() {
+        for (auto &b : list) {
+            b.mine->taken.store(false, std::memory_order_release);
+        }
+    }
+
+    std::vector<binding> list;
+};
+
+thread_local Concurrent::bindings Concurrent::_bindings;
+
+static std::atomic<uint64_t> last_id(0);
+
+// See Concurrent.h
+Concurrent::Concurrent(size_t size, size_t slab_size)
+    : _state(std::make_shared<state>(size, slab_size)), _id(++last_id) {
+    // Fine grained classes for small objects, geometric progression after, the largest takes 1/8 of slab
+    size_t max_object = slab_size / 8;
+    for (size_t object = class_step; object <= max_object;) {
+        _state->sizes.push_back(object);
+        size_t next = object < 8 * class_step ? object + class_step : object * 5 / 4;
+        object = (next + class_step - 1) / class_step * class_step;
+    }
+
+    size_t cls = 0;
+    _state->classes.push_back(0);
+    for (size_t steps = 1; !_state->sizes.empty() && steps <= _state->sizes.back() / class_step; steps++) {
+        while (_state->sizes[cls] < steps * class_step) {
+            cls++;
+        }
+        _state->classes.push_back(cls);
+    }
+}
+
+// See Concurrent.h
+Concurrent::~Concurrent() { _state->alive.store(false, std::memory_order_relaxed); }
+
+// See Concurrent.h
+void *Concurrent::alloc(size_t N) {
+    size_t steps = (N + class_step - 1) / class_step;
+    if (steps < _state->classes.size()) {
+        void *result = current()->pools[_state->classes[steps]]->alloc();
+        if (result != nullptr) {
+            return result;
+        }
+    }
+    return std::malloc(N);
+}
+
+// See Concurrent.h
+void Concurrent::free(void *p) {
+    if (!_state->arena.contains(p)) {
+        std::free(p);
+        return;
+    }
+
+    Mempool *owner = Mempool::owner(_state->arena.slab_of(p));
+    if (&owner->cache() == &current()->cache) {
+        owner->free(p);
+    } else {
+        owner->free_remote(p);
+    }
+}
+
+// See Concurrent.h
+size_t Concurrent::max_size() const { return _state->sizes.empty() ? 0 : _state->sizes.back(); }
+
+// See Concurrent.h
+std::string Concurrent::dump() const {
+    std::stringstream out;
+    out << "slabs " << _state->arena.slabs_used() << "/" << _state->arena.slabs_total() << " of "
+        << _state->arena.slab_size() << " bytes, " << _state->sizes.size() << " classes up to " << max_size()
+        << " bytes\n";
+
+    std::lock_guard<std::mutex> lock(_state->lock);
+    out << "threads states " << _state->locals.size() << "\n";
+    return out.str();
+}
+
+Concurrent::local *Concurrent::current() const {
+    auto &list = _bindings.list;
+    if (!list.empty() && list.front().id == _id) {
+        return list.front().mine;
+    }
+    for (auto &b : list) {
+        if (b.id == _id) {
+            return b.mine;
+        }
+    }
+
+    // First call from the thread, forget instances that are gone
+    for (auto it = list.begin(); it != list.end();) {
+        if (!it->shared->alive.load(std::memory_order_relaxed)) {
+            it->mine->taken.store(false, std::memory_order_release);
+            it = list.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_state->lock);
+    local *result = nullptr;
+    for (auto &l : _state->locals) {
+        bool expected = false;
+        if (l->taken.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            result = l.get();
+            break;
+        }
+    }
+    if (result == nullptr) {
+        _state->locals.emplace_back(new local(_state->arena, _state->sizes));
+        result = _state->locals.back().get();
+        result->taken.store(true, std::memory_order_relaxed);
+    }
+
+    list.push_back(bindings::binding{_id, _state, result});
+    return result;
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,136 @@
+#include "Mempool.h"
+
+namespace Afina {
+namespace Allocator {
+
+static const size_t object_align = alignof(std::max_align_t);
+
+// See Mempool.h
+Mempool::Mempool(SlabCache &cache, size_t object_size)
+    : _cache(cache), _object_size((object_size + object_align - 1) / object_align * object_align),
+      _data_offset((sizeof(slab_t) + object_align - 1) / object_align * object_align), _partial(nullptr),
+      _partial_count(0), _remote(nullptr) {}
+
+// See Mempool.h
+Mempool::~Mempool() {
+    // Slabs having objects in use die together with arena
+    collect();
+    while (_partial != nullptr) {
+        slab_t *slab = _partial;
+        unlink(slab);
+        if (slab->used == 0) {
+            _cache.put(slab);
+        }
+    }
+}
+
+// See Mempool.h
+void *Mempool::alloc() {
+    if (_partial == nullptr) {
+        collect();
+    }
+
+    slab_t *slab = _partial;
+    if (slab == nullptr) {
+        slab = grow();
+        if (slab == nullptr) {
+            return nullptr;
+        }
+    }
+
+    void *result;
+    if (slab->free_list != nullptr) {
+        result = slab->free_list;
+        slab->free_list = *static_cast<void **>(result);
+    } else {
+        result = slab->carve;
+        slab->carve += _object_size;
+    }
+    slab->used++;
+
+    char *end = reinterpret_cast<char *>(slab) + _cache.arena().slab_size();
+    if (slab->free_list == nullptr && slab->carve + _object_size > end) {
+        unlink(slab);
+    }
+    return result;
+}
+
+// See Mempool.h
+void Mempool::free(void *p) {
+    slab_t *slab = static_cast<slab_t *>(_cache.arena().slab_of(p));
+    *static_cast<void **>(p) = slab->free_list;
+    slab->free_list = p;
+    slab->used--;
+
+    if (!slab->listed) {
+        link(slab);
+    }
+
+    // Keep one slab even if it is empty, so pool that allocates and frees single object doesn't bounce slabs
+    if (slab->used == 0 && _partial_count > 1) {
+        unlink(slab);
+        _cache.put(slab);
+    }
+}
+
+// See Mempool.h
+void Mempool::free_remote(void *p) {
+    void *head = _remote.load(std::memory_order_relaxed);
+    do {
+        *static_cast<void **>(p) = head;
+    } while (!_remote.compare_exchange_weak(head, p, std::memory_order_release, std::memory_order_relaxed));
+}
+
+Mempool::slab_t *Mempool::grow() {
+    void *memory = _cache.get();
+    if (memory == nullptr) {
+        return nullptr;
+    }
+
+    // Arena link is left untouched, stale readers of the arena stack may still look at it
+    slab_t *slab = static_cast<slab_t *>(memory);
+    slab->owner = this;
+    slab->free_list = nullptr;
+    slab->carve = static_cast<char *>(memory) + _data_offset;
+    slab->used = 0;
+    slab->listed = false;
+    link(slab);
+    return slab;
+}
+
+void Mempool::collect() {
+    // Whole list is taken at once, so there is no ABA for the single consumer
+    void *p = _remote.exchange(nullptr, std::memory_order_acquire);
+    while (p != nullptr) {
+        void *next = *static_cast<void **>(p);
+        free(p);
+        p = next;
+    }
+}
+
+void Mempool::link(slab_t *slab) {
+    slab->prev = nullptr;
+    slab->next = _partial;
+    if (_partial != nullptr) {
+        _partial->prev = slab;
+    }
+    _partial = slab;
+    slab->listed = true;
+    _partial_count++;
+}
+
+void Mempool::unlink(slab_t *slab) {
+    if (slab->prev != nullptr) {
+        slab->prev->next = slab->next;
+    } else {
+        _partial = slab->next;
+    }
+    if (slab->next != nullptr) {
+        slab->next->prev = slab->prev;
+    }
+    slab->listed = false;
+    _partial_count--;
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,96 @@
+#ifndef AFINA_ALLOCATOR_MEMPOOL_H
+#define AFINA_ALLOCATOR_MEMPOOL_H
+
+#include <atomic>
+#include <cstddef>
+
+#include "SlabArena.h"
+#include "SlabCache.h"
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Pool of fixed size objects owned by a single thread
+ * Cuts objects out of slabs taken from the thread's SlabCache, every slab keeps its own free list so slab that has
+ * no objects in use anymore goes back to cache. Slabs having free objects are linked into list, allocation is
+ * served by the first of them.
+ *
+ * Objects freed by other threads are pushed into lock-free list and owner picks them up once it has no free
+ * objects left, so the only shared state between threads is that list.
+ *
+ * Except free_remote that is NOT thread safe implementaiton!!
+ */
+class Mempool {
+public:
+    Mempool(SlabCache &cache, size_t object_size);
+    ~Mempool();
+
+    /**
+     * Returns object, nullptr if there are no free slabs left
+     */
+    void *alloc();
+
+    /**
+     * Returns object allocated by this pool, must be called by the owner thread
+     */
+    void free(void *p);
+
+    /**
+     * Returns object allocated by this pool, could be called by any thread
+     */
+    void free_remote(void *p);
+
+    /**
+     * Pool that owns slab given away by the pool
+     */
+    static inline Mempool *owner(void *slab) { return static_cast<slab_t *>(slab)->owner; }
+
+    inline SlabCache &cache() { return _cache; }
+    inline size_t object_size() const { return _object_size; }
+
+private:
+    struct slab_t {
+        // Reserved by arena
+        SlabArena::link_t link;
+
+        Mempool *owner;
+
+        // Freed objects linked through their first word and part of slab never used yet
+        void *free_list;
+        char *carve;
+
+        size_t used;
+
+        // List of slabs having free objects
+        slab_t *prev;
+        slab_t *next;
+        bool listed;
+    };
+
+    // Takes new slab from cache and puts it in front of the list
+    slab_t *grow();
+
+    // Frees all the objects pushed by other threads
+    void collect();
+
+    void link(slab_t *slab);
+    void unlink(slab_t *slab);
+
+    SlabCache &_cache;
+    const size_t _object_size;
+
+    // Offset of the first object in slab
+    const size_t _data_offset;
+
+    slab_t *_partial;
+    size_t _partial_count;
+
+    // Objects freed by other threads, linked through their first word
+    std::atomic<void *> _remote;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_MEMPOOL_H
@@ -3,12 +3,23 @@
 namespace Afina {
 namespace Allocator {
 
-Pointer::Pointer() {}
-Pointer::Pointer(const Pointer &) {}
-Pointer::Pointer(Pointer &&) {}
+Pointer::Pointer() : _desc(nullptr) {}
+Pointer::Pointer(void **desc) : _desc(desc) {}
+Pointer::Pointer(const Pointer &other) : _desc(other._desc) {}
+Pointer::Pointer(Pointer &&other) : _desc(other._desc) { other._desc = nullptr; }
 
-Pointer &Pointer::operator=(const Pointer &) { return *this; }
-Pointer &Pointer::operator=(Pointer &&) { return *this; }
+Pointer &Pointer::operator=(const Pointer &other) {
+    _desc = other._desc;
+    return *this;
+}
+
+Pointer &Pointer::operator=(Pointer &&other) {
+    if (this != &other) {
+        _desc = other._desc;
+        other._desc = nullptr;
+    }
+    return *this;
+}
 
 } // namespace Allocator
 } // namespace Afina
@@ -1,40 +1,361 @@
 #include <afina/allocator/Simple.h>
 
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
-
-/**
- * TODO: semantics
- * @param N size_t
- */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
-
-/**
- * TODO: semantics
- * @param p Pointer
- * @param N size_t
- */
-void Simple::realloc(Pointer &p, size_t N) {}
-
-/**
- * TODO: semantics
- * @param p Pointer
- */
-void Simple::free(Pointer &p) {}
-
-/**
- * TODO: semantics
- */
-void Simple::defrag() {}
-
-/**
- * TODO: semantics
- */
-std::string Simple::dump() const { return ""; }
+// Header preceding every block, desc is nullptr for free blocks
+struct Simple::block_t {
+    size_t size;
+    void **desc;
+
+    inline char *data() { return reinterpret_cast<char *>(this + 1); }
+    inline block_t *next() { return reinterpret_cast<block_t *>(data() + size); }
+
+    // Neighbours in the bin, kept in data of free block
+    inline block_t *&bin_prev() { return reinterpret_cast<block_t **>(data())[0]; }
+    inline block_t *&bin_next() { return reinterpret_cast<block_t **>(data())[1]; }
+};
+
+// Descriptor of every pinned block, they have no own one
+static void *pinned_desc = nullptr;
+static void **const pinned = &pinned_desc;
+
+// Blocks are aligned the way malloc does
+static const size_t block_align = alignof(std::max_align_t);
+
+static inline size_t align_up(size_t size) { return (size + block_align - 1) / block_align * block_align; }
+
+// Bins below this one have exact sizes, the rest are powers of 2 starting from its size
+static const size_t exact_bins = 64;
+static const size_t last_bin = 127;
+
+static inline size_t bin_of(size_t size) {
+    size_t bin = size / block_align;
+    if (bin < exact_bins) {
+        return bin;
+    }
+
+    bin = exact_bins;
+    for (size = size / (exact_bins * block_align); size > 1 && bin < last_bin; size /= 2) {
+        bin++;
+    }
+    return bin;
+}
+
+Simple::Simple(void *base, size_t size) : _base(base), _base_len(size), _free_bytes(0), _pinned(0), _free_desc(nullptr) {
+    static_assert(last_bin + 1 == bins_count, "Bin of any size must exist");
+    std::memset(_bins, 0, sizeof(_bins));
+    std::memset(_bins_used, 0, sizeof(_bins_used));
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(base);
+    uintptr_t end = start + size;
+    start = (start + block_align - 1) / block_align * block_align;
+    end = end / alignof(void *) * alignof(void *);
+    if (start > end) {
+        start = end;
+    }
+
+    _top = reinterpret_cast<char *>(start);
+    _table = reinterpret_cast<void **>(end);
+    _base = _top;
+}
+
+// See Simple.h
+Pointer Simple::alloc(size_t N) {
+    void **desc = take_descriptor();
+    if (desc == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No space left for descriptor");
+    }
+
+    block_t *block = place(N);
+    if (block == nullptr) {
+        *desc = _free_desc;
+        _free_desc = desc;
+        throw AllocError(AllocErrorType::NoMemory, "No free block large enough");
+    }
+
+    block->desc = desc;
+    *desc = block->data();
+    return Pointer(desc);
+}
+
+// See Simple.h
+void Simple::realloc(Pointer &p, size_t N) {
+    if (p._desc == nullptr) {
+        p = alloc(N);
+        return;
+    }
+
+    size_t size = align_up(N);
+    block_t *block = reinterpret_cast<block_t *>(*p._desc) - 1;
+    if (size <= block->size) {
+        split(block, size);
+        return;
+    }
+
+    // Absorb free neighbours, the top as well if block is the last one
+    block_t *next = block->next();
+    while (reinterpret_cast<char *>(next) < _top && next->desc == nullptr) {
+        unlink(next);
+        _free_bytes -= sizeof(block_t) + next->size;
+        block->size += sizeof(block_t) + next->size;
+        next = block->next();
+    }
+    if (reinterpret_cast<char *>(next) == _top &&
+        size <= static_cast<size_t>(reinterpret_cast<char *>(_table) - block->data())) {
+        block->size = size;
+        _top = reinterpret_cast<char *>(block->next());
+        return;
+    }
+    if (size <= block->size) {
+        split(block, size);
+        return;
+    }
+
+    // Block itself could be moved by compaction while looking for space
+    block_t *moved = place(size);
+    if (moved == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free block large enough");
+    }
+    block = reinterpret_cast<block_t *>(*p._desc) - 1;
+
+    std::memcpy(moved->data(), block->data(), block->size);
+    moved->desc = p._desc;
+    *p._desc = moved->data();
+
+    block->desc = nullptr;
+    _free_bytes += sizeof(block_t) + block->size;
+    merge(block);
+}
+
+// See Simple.h
+void Simple::free(Pointer &p) {
+    if (p._desc == nullptr) {
+        return;
+    }
+
+    block_t *block = reinterpret_cast<block_t *>(*p._desc) - 1;
+    block->desc = nullptr;
+    _free_bytes += sizeof(block_t) + block->size;
+    merge(block);
+
+    *p._desc = _free_desc;
+    _free_desc = p._desc;
+    p._desc = nullptr;
+}
+
+// See Simple.h
+void *Simple::alloc_pinned(size_t N) {
+    block_t *block = place(N);
+    if (block == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free block large enough");
+    }
+
+    block->desc = pinned;
+    _pinned++;
+    return block->data();
+}
+
+// See Simple.h
+void Simple::free_pinned(void *p) {
+    if (p == nullptr) {
+        return;
+    }
+
+    block_t *block = static_cast<block_t *>(p) - 1;
+    if (block->desc != pinned) {
+        throw AllocError(AllocErrorType::InvalidFree, "Block isn't pinned");
+    }
+
+    block->desc = nullptr;
+    _pinned--;
+    _free_bytes += sizeof(block_t) + block->size;
+    merge(block);
+}
+
+// See Simple.h
+void Simple::defrag() {
+    _free_bytes = 0;
+    std::memset(_bins, 0, sizeof(_bins));
+    std::memset(_bins_used, 0, sizeof(_bins_used));
+
+    char *dst = static_cast<char *>(_base);
+    for (block_t *block = static_cast<block_t *>(_base); reinterpret_cast<char *>(block) < _top;) {
+        block_t *next = block->next();
+        if (block->desc == pinned) {
+            // Space in front of the pinned block stays as a hole
+            if (reinterpret_cast<char *>(block) != dst) {
+                block_t *hole = reinterpret_cast<block_t *>(dst);
+                hole->size = reinterpret_cast<char *>(block) - hole->data();
+                hole->desc = nullptr;
+                _free_bytes += sizeof(block_t) + hole->size;
+                link(hole);
+            }
+            dst = reinterpret_cast<char *>(next);
+        } else if (block->desc != nullptr) {
+            size_t total = sizeof(block_t) + block->size;
+            if (reinterpret_cast<char *>(block) != dst) {
+                std::memmove(dst, block, total);
+                block_t *moved = reinterpret_cast<block_t *>(dst);
+                *moved->desc = moved->data();
+            }
+            dst += total;
+        }
+        block = next;
+    }
+    _top = dst;
+}
+
+// See Simple.h
+std::string Simple::dump() const {
+    std::stringstream out;
+    char *start = static_cast<char *>(_base);
+    for (block_t *block = static_cast<block_t *>(_base); reinterpret_cast<char *>(block) < _top;
+         block = block->next()) {
+        out << (reinterpret_cast<char *>(block) - start) << ": " << block->size << " "
+            << (block->desc == pinned ? "pinned" : block->desc != nullptr ? "used" : "free") << "\n";
+    }
+    out << (_top - start) << ": " << (reinterpret_cast<char *>(_table) - _top) << " top\n";
+    return out.str();
+}
+
+Simple::block_t *Simple::place(size_t N) {
+    size_t size = align_up(N);
+    if (sizeof(block_t) + size <= _free_bytes) {
+        block_t *hole = first_fit(size);
+        if (hole != nullptr) {
+            return hole;
+        }
+    }
+
+    size_t room = reinterpret_cast<char *>(_table) - _top;
+    if (sizeof(block_t) + size > room) {
+        if (sizeof(block_t) + size > room + _free_bytes) {
+            return nullptr;
+        }
+
+        // Free blocks are too small or scattered, compaction cost is paid back by the amount of space it frees
+        defrag();
+        room = reinterpret_cast<char *>(_table) - _top;
+        if (sizeof(block_t) + size > room) {
+            return first_fit(size);
+        }
+    }
+
+    block_t *block = reinterpret_cast<block_t *>(_top);
+    block->size = size;
+    _top = reinterpret_cast<char *>(block->next());
+    return block;
+}
+
+Simple::block_t *Simple::first_fit(size_t N) {
+    for (size_t bin = bin_of(N); bin < bins_count; bin++) {
+        // Skip empty bins
+        uint64_t used = _bins_used[bin / 64] >> (bin % 64);
+        if (used == 0) {
+            bin = bin / 64 * 64 + 63;
+            continue;
+        }
+        bin += __builtin_ctzll(used);
+
+        for (block_t *block = _bins[bin]; block != nullptr; block = block->bin_next()) {
+            if (block->size >= N) {
+                // Block is taken as whole, then its tail is given back
+                unlink(block);
+                _free_bytes -= sizeof(block_t) + block->size;
+                split(block, N);
+                return block;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void Simple::split(block_t *block, size_t N) {
+    if (block->size < N + sizeof(block_t) + block_align) {
+        return;
+    }
+
+    block_t *rest = reinterpret_cast<block_t *>(block->data() + N);
+    rest->size = block->size - N - sizeof(block_t);
+    rest->desc = nullptr;
+    block->size = N;
+    _free_bytes += sizeof(block_t) + rest->size;
+    merge(rest);
+}
+
+void Simple::merge(block_t *block) {
+    block_t *next = block->next();
+    while (reinterpret_cast<char *>(next) < _top && next->desc == nullptr) {
+        unlink(next);
+        block->size += sizeof(block_t) + next->size;
+        next = block->next();
+    }
+
+    if (reinterpret_cast<char *>(next) == _top) {
+        _free_bytes -= sizeof(block_t) + block->size;
+        _top = reinterpret_cast<char *>(block);
+    } else {
+        link(block);
+    }
+}
+
+void Simple::link(block_t *block) {
+    if (block->size < 2 * sizeof(block_t *)) {
+        return;
+    }
+
+    size_t bin = bin_of(block->size);
+    block->bin_prev() = nullptr;
+    block->bin_next() = _bins[bin];
+    if (_bins[bin] != nullptr) {
+        _bins[bin]->bin_prev() = block;
+    }
+    _bins[bin] = block;
+    _bins_used[bin / 64] |= uint64_t(1) << (bin % 64);
+}
+
+void Simple::unlink(block_t *block) {
+    if (block->size < 2 * sizeof(block_t *)) {
+        return;
+    }
+
+    size_t bin = bin_of(block->size);
+    if (block->bin_prev() != nullptr) {
+        block->bin_prev()->bin_next() = block->bin_next();
+    } else {
+        _bins[bin] = block->bin_next();
+    }
+    if (block->bin_next() != nullptr) {
+        block->bin_next()->bin_prev() = block->bin_prev();
+    }
+    if (_bins[bin] == nullptr) {
+        _bins_used[bin / 64] &= ~(uint64_t(1) << (bin % 64));
+    }
+}
+
+void **Simple::take_descriptor() {
+    if (_free_desc != nullptr) {
+        void **desc = _free_desc;
+        _free_desc = static_cast<void **>(*desc);
+        return desc;
+    }
+
+    if (reinterpret_cast<char *>(_table - 1) < _top) {
+        if (_free_bytes < sizeof(void *)) {
+            return nullptr;
+        }
+        defrag();
+    }
+    return --_table;
+}
 
 } // namespace Allocator
 } // namespace Afina
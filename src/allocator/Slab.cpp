@@ -0,0 +1,115 @@
+#include <afina/allocator/Slab.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Allocator {
+
+// Chunks are aligned enough to hold any pointer-based structure
+static const size_t chunk_align = alignof(void *);
+static const size_t min_chunk = 64;
+
+// See Slab.h
+Slab::Slab(void *base, size_t size, size_t slab_size, double factor)
+    : _base(static_cast<char *>(base)), _slab_size(std::min(slab_size, size)), _slabs_total(0) {
+    if (_slab_size > 0) {
+        _slab_owner.assign(size / _slab_size, -1);
+    }
+
+    // Geometric progression of chunk sizes, the last class takes whole slab
+    size_t chunk = min_chunk;
+    while (chunk < _slab_size / 2) {
+        _classes.push_back(size_class_t{chunk, nullptr, nullptr, nullptr, 0, 0});
+        size_t next = static_cast<size_t>(chunk * factor);
+        chunk = std::max(chunk + chunk_align, (next + chunk_align - 1) / chunk_align * chunk_align);
+    }
+    if (_slab_size >= chunk_align) {
+        _classes.push_back(size_class_t{_slab_size / chunk_align * chunk_align, nullptr, nullptr, nullptr, 0, 0});
+    }
+}
+
+// See Slab.h
+void *Slab::alloc(size_t N) {
+    int cls = size_class(N);
+    if (cls < 0) {
+        return nullptr;
+    }
+
+    size_class_t &c = _classes[cls];
+    if (c.free_list != nullptr) {
+        void *result = c.free_list;
+        c.free_list = *static_cast<void **>(result);
+        c.used++;
+        return result;
+    }
+
+    if (c.carve == nullptr || c.carve + c.chunk_size > c.carve_end) {
+        if (_slabs_total == _slab_owner.size()) {
+            return nullptr;
+        }
+
+        // Take next never used slab, it will be cut into chunks on demand
+        _slab_owner[_slabs_total] = cls;
+        c.carve = _base + _slabs_total * _slab_size;
+        c.carve_end = c.carve + _slab_size;
+        c.slabs++;
+        _slabs_total++;
+    }
+
+    void *result = c.carve;
+    c.carve += c.chunk_size;
+    c.used++;
+    return result;
+}
+
+// See Slab.h
+void Slab::free(void *p) {
+    int cls = size_class(p);
+    if (cls < 0) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to allocator");
+    }
+
+    size_class_t &c = _classes[cls];
+    *static_cast<void **>(p) = c.free_list;
+    c.free_list = p;
+    c.used--;
+}
+
+// See Slab.h
+int Slab::size_class(size_t N) const {
+    // Classes are sorted by chunk size, binary search for the first that fits
+    auto it = std::lower_bound(_classes.begin(), _classes.end(), N,
+                               [](const size_class_t &c, size_t size) { return c.chunk_size < size; });
+    if (it == _classes.end()) {
+        return -1;
+    }
+    return it - _classes.begin();
+}
+
+// See Slab.h
+int Slab::size_class(void *p) const {
+    char *ptr = static_cast<char *>(p);
+    if (ptr < _base || ptr >= _base + _slabs_total * _slab_size) {
+        return -1;
+    }
+    return _slab_owner[(ptr - _base) / _slab_size];
+}
+
+// See Slab.h
+std::string Slab::dump() const {
+    std::stringstream out;
+    out << "slabs " << _slabs_total << "/" << _slab_owner.size() << " of " << _slab_size << " bytes\n";
+    for (size_t i = 0; i < _classes.size(); i++) {
+        const size_class_t &c = _classes[i];
+        if (c.slabs > 0) {
+            out << "class " << i << ": chunk " << c.chunk_size << ", slabs " << c.slabs << ", used " << c.used << "\n";
+        }
+    }
+    return out.str();
+}
+
+} // namespace Allocator
+} // namespace Afina
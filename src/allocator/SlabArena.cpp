@@ -0,0 +1,70 @@
+#include "SlabArena.h"
+
+#include <stdexcept>
+
+#include <sys/mman.h>
+
+namespace Afina {
+namespace Allocator {
+
+// See SlabArena.h
+SlabArena::SlabArena(size_t size, size_t slab_size)
+    : _slab_size(slab_size), _slabs_count(size / slab_size), _fresh(0), _free(0), _used(0) {
+    if (slab_size == 0 || (slab_size & (slab_size - 1)) != 0) {
+        throw std::invalid_argument("Slab size must be power of 2");
+    }
+
+    // Extra slab to align start, pages are only reserved and get backed by memory once touched
+    _mapping_size = _slabs_count * _slab_size + _slab_size;
+    _mapping = mmap(nullptr, _mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (_mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map slab arena");
+    }
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(_mapping);
+    _base = reinterpret_cast<char *>((start + _slab_size - 1) & ~(_slab_size - 1));
+}
+
+// See SlabArena.h
+SlabArena::~SlabArena() { munmap(_mapping, _mapping_size); }
+
+// See SlabArena.h
+void *SlabArena::map() {
+    uint64_t head = _free.load(std::memory_order_acquire);
+    while ((head & 0xffffffff) != 0) {
+        link_t *top = slab(uint32_t(head) - 1);
+
+        // Slab could be taken and reused by other thread meanwhile, link is garbage then but tag makes CAS fail
+        uint64_t next = (head & ~uint64_t(0xffffffff)) + (uint64_t(1) << 32);
+        next |= top->next.load(std::memory_order_relaxed);
+        if (_free.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+            _used.fetch_add(1, std::memory_order_relaxed);
+            return top;
+        }
+    }
+
+    uint32_t fresh = _fresh.load(std::memory_order_relaxed);
+    while (fresh < _slabs_count) {
+        if (_fresh.compare_exchange_weak(fresh, fresh + 1, std::memory_order_relaxed)) {
+            _used.fetch_add(1, std::memory_order_relaxed);
+            return slab(fresh);
+        }
+    }
+    return nullptr;
+}
+
+// See SlabArena.h
+void SlabArena::unmap(void *p) {
+    link_t *link = static_cast<link_t *>(p);
+    uint32_t index = (static_cast<char *>(p) - _base) / _slab_size;
+
+    uint64_t head = _free.load(std::memory_order_relaxed);
+    do {
+        link->next.store(uint32_t(head), std::memory_order_relaxed);
+    } while (!_free.compare_exchange_weak(head, (head & ~uint64_t(0xffffffff)) | (index + 1),
+                                          std::memory_order_release, std::memory_order_relaxed));
+    _used.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,80 @@
+#ifndef AFINA_ALLOCATOR_SLAB_ARENA_H
+#define AFINA_ALLOCATOR_SLAB_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Arena of slabs shared by all threads
+ * Reserves memory area once and cuts it into slabs aligned by their size, so slab of any address inside arena is
+ * found by masking. Slabs returned to arena are kept in lock-free stack, counter tag in the stack head protects
+ * it from ABA. Never returned slabs are taken by atomic bump.
+ *
+ * First bytes of every slab given away are reserved for the stack link, see link_t.
+ */
+class SlabArena {
+public:
+    // Header every slab starts with, owner of the slab must not touch it
+    struct link_t {
+        std::atomic<uint32_t> next;
+    };
+
+    /**
+     * @param size size of the area to reserve, rounded down to whole slabs
+     * @param slab_size size of a single slab, must be power of 2
+     */
+    SlabArena(size_t size, size_t slab_size);
+    ~SlabArena();
+
+    /**
+     * Returns free slab, nullptr if arena is exhausted
+     */
+    void *map();
+
+    /**
+     * Returns slab back to arena, any thread could do it
+     */
+    void unmap(void *slab);
+
+    inline bool contains(const void *p) const {
+        const char *ptr = static_cast<const char *>(p);
+        return ptr >= _base && ptr < _base + _slabs_count * _slab_size;
+    }
+
+    // Slab the address inside arena belongs to
+    inline void *slab_of(const void *p) const {
+        return _base + ((static_cast<const char *>(p) - _base) & ~(_slab_size - 1));
+    }
+
+    inline size_t slab_size() const { return _slab_size; }
+    inline size_t slabs_total() const { return _slabs_count; }
+    inline size_t slabs_used() const { return _used.load(std::memory_order_relaxed); }
+
+private:
+    inline link_t *slab(uint32_t index) const { return reinterpret_cast<link_t *>(_base + index * _slab_size); }
+
+    // Reserved mapping and aligned start of slabs inside it
+    void *_mapping;
+    size_t _mapping_size;
+    char *_base;
+
+    const size_t _slab_size;
+    uint32_t _slabs_count;
+
+    // Slabs never given away start from this one
+    std::atomic<uint32_t> _fresh;
+
+    // Stack of returned slabs: tag in the high half, index + 1 of the top slab in the low one, 0 if empty
+    std::atomic<uint64_t> _free;
+
+    std::atomic<size_t> _used;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_ARENA_H
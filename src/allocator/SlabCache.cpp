@@ -0,0 +1,34 @@
+#include "SlabCache.h"
+
+namespace Afina {
+namespace Allocator {
+
+// See SlabCache.h
+SlabCache::~SlabCache() {
+    for (auto slab : _slabs) {
+        _arena.unmap(slab);
+    }
+}
+
+// See SlabCache.h
+void *SlabCache::get() {
+    if (_slabs.empty()) {
+        return _arena.map();
+    }
+
+    void *slab = _slabs.back();
+    _slabs.pop_back();
+    return slab;
+}
+
+// See SlabCache.h
+void SlabCache::put(void *slab) {
+    if (_slabs.size() < _spare) {
+        _slabs.push_back(slab);
+    } else {
+        _arena.unmap(slab);
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,46 @@
+#ifndef AFINA_ALLOCATOR_SLAB_CACHE_H
+#define AFINA_ALLOCATOR_SLAB_CACHE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "SlabArena.h"
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Thread local cache of empty slabs
+ * Keeps few slabs released by mempools of the thread, so pools that shrink and grow back don't go to the shared
+ * arena every time.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class SlabCache {
+public:
+    SlabCache(SlabArena &arena, size_t spare = 4) : _arena(arena), _spare(spare) {}
+    ~SlabCache();
+
+    /**
+     * Empty slab, nullptr if arena is exhausted
+     */
+    void *get();
+
+    /**
+     * Gives empty slab back, it goes to arena once cache is full
+     */
+    void put(void *slab);
+
+    inline SlabArena &arena() { return _arena; }
+
+private:
+    SlabArena &_arena;
+    const size_t _spare;
+
+    std::vector<void *> _slabs;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_CACHE_H
@@ -5,37 +5,40 @@ namespace Concurrency {
 
     Executor::Executor(std::string name, int low_watermark, int high_watermark,
         int max_queue_size, int idle_time)
-        : _name(name)
+        : _state(State::kStopped)
+        , _name(name)
         , _low_watermark(low_watermark)
-        , _high_watermark(high_watermark)
+        , _high_watermark(std::max(low_watermark, high_watermark))
         , _max_queue_size(max_queue_size)
         , _idle_time(idle_time)
+        , _free_threads(0)
+        , _curr_threads(0)
     {
     }
 
-    Executor::~Executor() {}
+    Executor::~Executor() { Stop(true); }
 
     void Executor::Start()
     {
+        std::unique_lock<std::mutex> lock(_mutex);
         _state = State::kRun;
-        _free_threads = 0;
         for (int i = 0; i < _low_watermark; ++i) {
             _curr_threads++;
-            std::thread _work(&_perform_task, this);
-            _work.detach();
+            _add_thread();
         }
     }
 
     void Executor::Stop(bool await)
     {
         std::unique_lock<std::mutex> lock(_mutex);
-        _state = State::kStopping;
+        if (_state == State::kRun) {
+            _state = _curr_threads > 0 ? State::kStopping : State::kStopped;
+        }
         empty_condition.notify_all();
 
-        while (!_threads.empty()) {
-            _stop_cv.wait(lock);
+        if (await) {
+            _stop_cv.wait(lock, [this]() { return _state == State::kStopped; });
         }
-        _state = State::kStopped;
     }
 
     void Executor::_add_thread()
@@ -46,38 +49,41 @@ namespace Concurrency {
 
     void _perform_task(Executor* exec)
     {
-        while (exec->_state == Executor::State::kRun) {
-            std::function<void()> task;
-            auto time_until = std::chrono::system_clock::now()
-                + std::chrono::milliseconds(exec->_idle_time);
-
-            {
-                std::unique_lock<std::mutex> lock(exec->_mutex);
-                while (exec->_tasks.empty() && exec->_state == Executor::State::kRun) {
-                    exec->_free_threads++;
-                    if (exec->empty_condition.wait_until(lock, time_until) == std::cv_status::timeout) {
-                        if (exec->_curr_threads > exec->_low_watermark) {
-                            exec->_curr_threads--;
-                            return;
-                        } else {
-                            exec->empty_condition.wait(lock);
-                        }
-                    }
-                    exec->_free_threads--;
+        std::unique_lock<std::mutex> lock(exec->_mutex);
+        for (;;) {
+            auto time_until = std::chrono::steady_clock::now() + std::chrono::milliseconds(exec->_idle_time);
+            bool expired = false;
+            exec->_free_threads++;
+            while (exec->_tasks.empty() && exec->_state == Executor::State::kRun && !expired) {
+                if (exec->_curr_threads <= exec->_low_watermark) {
+                    exec->empty_condition.wait(lock);
+                } else if (exec->empty_condition.wait_until(lock, time_until) == std::cv_status::timeout) {
+                    // Idle thread above low watermark leaves
+                    expired = exec->_tasks.empty() && exec->_curr_threads > exec->_low_watermark;
                 }
-                task = exec->_tasks.front();
-                exec->_tasks.pop_front();
             }
+            exec->_free_threads--;
 
-            task();
-        }
+            // Enqueued tasks are completed even once pool is stopping
+            if (exec->_tasks.empty()) {
+                break;
+            }
 
-        {
-            std::unique_lock<std::mutex> lock(exec->_mutex);
-            exec->_curr_threads--;
-            if (exec->_curr_threads == 0) {
-                exec->_stop_cv.notify_all();
+            auto task = std::move(exec->_tasks.front());
+            exec->_tasks.pop_front();
+            lock.unlock();
+            try {
+                task();
+            } catch (...) {
+                // Task is responsible for own errors, pool thread must survive them
             }
+            lock.lock();
+        }
+
+        exec->_curr_threads--;
+        if (exec->_curr_threads == 0 && exec->_state == Executor::State::kStopping) {
+            exec->_state = Executor::State::kStopped;
+            exec->_stop_cv.notify_all();
         }
     }
 }
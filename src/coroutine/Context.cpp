@@ -0,0 +1,121 @@
+#include "Context.h"
+
+#include <cstdint>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef AFINA_COROUTINE_SWITCH_ASM
+// New stack is prepared so that the first switch "returns" into afina_coroutine_entry with r12 holding argument
+// and r13 function to call with it. Entry calls it with stack aligned as ABI wants, function never returns.
+extern "C" void afina_coroutine_entry();
+
+asm(".text\n"
+    ".globl afina_coroutine_swap\n"
+    ".hidden afina_coroutine_swap\n"
+    ".type afina_coroutine_swap, @function\n"
+    "afina_coroutine_swap:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size afina_coroutine_swap, .-afina_coroutine_swap\n"
+    ".globl afina_coroutine_entry\n"
+    ".hidden afina_coroutine_entry\n"
+    ".type afina_coroutine_entry, @function\n"
+    "afina_coroutine_entry:\n"
+    "    movq %r12, %rdi\n"
+    "    callq *%r13\n"
+    "    ud2\n"
+    ".size afina_coroutine_entry, .-afina_coroutine_entry\n");
+#endif
+
+namespace Afina {
+namespace Coroutine {
+
+namespace {
+
+typedef void (*entry_func)(void *);
+
+#ifndef AFINA_COROUTINE_SWITCH_ASM
+// makecontext passes int arguments only, so pointers are splitted in halves
+uintptr_t Join(unsigned hi, unsigned lo) { return (uintptr_t(hi) << 16 << 16) | uintptr_t(lo); }
+
+void Trampoline(unsigned func_hi, unsigned func_lo, unsigned arg_hi, unsigned arg_lo) {
+    entry_func func = reinterpret_cast<entry_func>(Join(func_hi, func_lo));
+    func(reinterpret_cast<void *>(Join(arg_hi, arg_lo)));
+}
+#endif
+
+} // namespace
+
+// See Context.h
+char *MapStack(std::size_t &size) {
+    std::size_t page = sysconf(_SC_PAGESIZE);
+    std::size_t length = (size + page - 1) / page * page + page;
+    void *stack = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (stack == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // Stack grows down, so guard page is the lowest one
+    if (mprotect(stack, page, PROT_NONE) != 0) {
+        munmap(stack, length);
+        return nullptr;
+    }
+
+    size = length;
+    return static_cast<char *>(stack);
+}
+
+// See Context.h
+void UnmapStack(char *stack, std::size_t size) { munmap(stack, size); }
+
+// See Context.h
+void Prepare(Registers &regs, char *stack, std::size_t size, void (*entry)(void *), void *arg) {
+#ifdef AFINA_COROUTINE_SWITCH_ASM
+    // Frame the way afina_coroutine_swap leaves it: control words, r15..r12, rbx, rbp, return address. Once it
+    // returns into entry stack pointer is 16 bytes aligned
+    uintptr_t top = reinterpret_cast<uintptr_t>(stack + size);
+    uint64_t *frame = reinterpret_cast<uint64_t *>((top & ~uintptr_t(15)) - 16);
+    *--frame = reinterpret_cast<uint64_t>(&afina_coroutine_entry);
+    *--frame = 0;                                 // rbp
+    *--frame = 0;                                 // rbx
+    *--frame = reinterpret_cast<uint64_t>(arg);   // r12
+    *--frame = reinterpret_cast<uint64_t>(entry); // r13
+    *--frame = 0;                                 // r14
+    *--frame = 0;                                 // r15
+    *--frame = (uint64_t(0x037F) << 32) | 0x1F80; // default x87 control word and mxcsr
+    regs.sp = frame;
+#else
+    std::size_t page = sysconf(_SC_PAGESIZE);
+    getcontext(&regs.uc);
+    regs.uc.uc_stack.ss_sp = stack + page;
+    regs.uc.uc_stack.ss_size = size - page;
+    regs.uc.uc_link = nullptr;
+    uintptr_t func = reinterpret_cast<uintptr_t>(entry);
+    uintptr_t ptr = reinterpret_cast<uintptr_t>(arg);
+    makecontext(&regs.uc, reinterpret_cast<void (*)()>(&Trampoline), 4, unsigned(func >> 16 >> 16), unsigned(func),
+                unsigned(ptr >> 16 >> 16), unsigned(ptr));
+#endif
+}
+
+} // namespace Coroutine
+} // namespace Afina
@@ -0,0 +1,64 @@
+#ifndef AFINA_COROUTINE_CONTEXT_H
+#define AFINA_COROUTINE_CONTEXT_H
+
+#include <cstddef>
+
+// Hand written switch is x86-64 only, -DAFINA_COROUTINE_UCONTEXT forces fallback anywhere
+#if defined(__x86_64__) && !defined(AFINA_COROUTINE_UCONTEXT)
+#define AFINA_COROUTINE_SWITCH_ASM
+#else
+#include <ucontext.h>
+#endif
+
+#ifdef AFINA_COROUTINE_SWITCH_ASM
+// Saves callee-saved registers, mxcsr and x87 control word on the current stack, stores stack pointer in *from
+// and pops the same set from the stack `to` points to. Returns to wherever `to` was suspended
+extern "C" void afina_coroutine_swap(void **from, void *to);
+#endif
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * Saved registers of suspended routine. Routine running on thread stack gets them on the first switch away
+ */
+struct Registers {
+#ifdef AFINA_COROUTINE_SWITCH_ASM
+    // Stack pointer of suspended routine, registers are saved right there
+    void *sp = nullptr;
+#else
+    ucontext_t uc;
+#endif
+};
+
+/**
+ * Maps stack of the given size plus guard page below it, size is rounded up to pages. Returns nullptr on failure
+ */
+char *MapStack(std::size_t &size);
+
+/**
+ * Unmaps stack returned by MapStack along with its guard page
+ */
+void UnmapStack(char *stack, std::size_t size);
+
+/**
+ * Prepares registers so that the first switch into them calls entry(arg) on top of the given stack. Entry must
+ * never return, it has to switch away for the last time instead
+ */
+void Prepare(Registers &regs, char *stack, std::size_t size, void (*entry)(void *), void *arg);
+
+/**
+ * Saves registers of the running code into from and resumes code suspended in to
+ */
+inline void Swap(Registers &from, Registers &to) {
+#ifdef AFINA_COROUTINE_SWITCH_ASM
+    afina_coroutine_swap(&from.sp, to.sp);
+#else
+    swapcontext(&from.uc, &to.uc);
+#endif
+}
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_CONTEXT_H
@@ -1,13 +1,249 @@
 #include <afina/coroutine/Engine.h>
 
+#include <array>
+#include <cerrno>
 #include <cstring>
 #include <setjmp.h>
+#include <stdexcept>
 #include <stdio.h>
 #include <string.h>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <unistd.h>
 
 namespace Afina {
 namespace Coroutine {
 
+namespace {
+
+// Ready descriptors and timers are checked at least that often while routines keep yielding to each other
+const std::chrono::milliseconds poll_interval(1);
+
+} // namespace
+
+Engine::~Engine() {
+    while (!timers.empty()) {
+        context *ctx = timers.top().routine;
+        timers.pop();
+        if (--ctx->timers_pending == 0 && ctx->zombie) {
+            Free(ctx);
+        }
+    }
+    for (context *ctx = pool.Pop(); ctx != nullptr; ctx = pool.Pop()) {
+        Free(ctx);
+    }
+    if (epoll_fd != -1) {
+        close(epoll_fd);
+    }
+}
+
+Engine::context *Engine::Acquire() {
+    context *ctx = pool.Get();
+    if (ctx == nullptr) {
+        ctx = new context();
+    }
+    ctx->blocked = false;
+    ctx->timer = 0;
+    ctx->events = 0;
+    return ctx;
+}
+
+void Engine::Release(context *ctx) {
+    // Copy buffer stays with context, next routine reuses it unless stack gets deeper
+    if (pool.Put(ctx)) {
+        return;
+    }
+
+    // Recycled context gets new timer ids, so stale timers never match it. Freed one must wait for them to go
+    if (ctx->timers_pending > 0) {
+        ctx->zombie = true;
+    } else {
+        Free(ctx);
+    }
+}
+
+void Engine::Free(context *ctx) {
+    delete[] std::get<0>(ctx->Stack);
+    delete ctx;
+}
+
+void Engine::Link(context *&list, context *ctx) {
+    ctx->prev = nullptr;
+    ctx->next = list;
+    if (list != nullptr) {
+        list->prev = ctx;
+    }
+    list = ctx;
+}
+
+void Engine::Unlink(context *&list, context *ctx) {
+    if (ctx->prev != nullptr) {
+        ctx->prev->next = ctx->next;
+    }
+    if (ctx->next != nullptr) {
+        ctx->next->prev = ctx->prev;
+    }
+    if (list == ctx) {
+        list = ctx->next;
+    }
+    ctx->prev = ctx->next = nullptr;
+}
+
+void Engine::Schedule() {
+    while (alive != nullptr || blocked != nullptr) {
+        if (alive != nullptr) {
+            yield();
+        } else if (!Poll(-1)) {
+            break;
+        }
+    }
+
+    // Deadlock: nobody is going to unblock the rest
+    while (blocked != nullptr) {
+        context *ctx = blocked;
+        Unlink(blocked, ctx);
+        Release(ctx);
+    }
+}
+
+bool Engine::Poll(int timeout) {
+    if (io_waiters == 0 && timers.empty()) {
+        return false;
+    }
+
+    // Sleep no longer than the nearest timer
+    last_poll = std::chrono::steady_clock::now();
+    if (!timers.empty()) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(timers.top().deadline - last_poll);
+        int until_timer = left.count() < 0 ? 0 : left.count() + 1;
+        if (timeout < 0 || until_timer < timeout) {
+            timeout = until_timer;
+        }
+    }
+
+    if (io_waiters > 0) {
+        std::array<struct epoll_event, 64> ready;
+        int nready = epoll_wait(epoll_fd, &ready[0], ready.size(), timeout);
+        for (int i = 0; i < nready; i++) {
+            // Descriptor is registered one shot, it won't be reported again until next wait
+            context *ctx = static_cast<context *>(ready[i].data.ptr);
+            ctx->events = ready[i].events;
+            io_waiters--;
+            unblock(ctx);
+        }
+    } else if (timeout > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    while (!timers.empty() && timers.top().deadline <= now) {
+        context *ctx = timers.top().routine;
+        uint64_t id = timers.top().id;
+        timers.pop();
+
+        ctx->timers_pending--;
+        if (ctx->timer == id) {
+            ctx->timer = 0;
+            unblock(ctx);
+        } else if (ctx->zombie && ctx->timers_pending == 0) {
+            Free(ctx);
+        }
+    }
+    return true;
+}
+
+void Engine::Timer(std::chrono::milliseconds timeout) {
+    cur_routine->timer = ++last_timer;
+    cur_routine->timers_pending++;
+    timers.push(timer{std::chrono::steady_clock::now() + timeout, last_timer, cur_routine});
+}
+
+void *Engine::current() const {
+    if (cur_routine == idle_ctx) {
+        return nullptr;
+    }
+    return cur_routine;
+}
+
+void Engine::block(void *routine_) {
+    context *ctx = static_cast<context *>(routine_ == nullptr ? current() : routine_);
+    if (ctx == nullptr || ctx->blocked) {
+        return;
+    }
+
+    Unlink(alive, ctx);
+    Link(blocked, ctx);
+    ctx->blocked = true;
+
+    // Current routine can't continue, someone else runs. Idle one sleeps until something unblocks
+    if (ctx == cur_routine) {
+        sched(alive != nullptr ? alive : idle_ctx);
+    }
+}
+
+void Engine::unblock(void *routine_) {
+    context *ctx = static_cast<context *>(routine_);
+    if (ctx == nullptr || !ctx->blocked) {
+        return;
+    }
+
+    Unlink(blocked, ctx);
+    Link(alive, ctx);
+    ctx->blocked = false;
+}
+
+void Engine::sleep_for(std::chrono::milliseconds timeout) {
+    if (current() == nullptr) {
+        return;
+    }
+
+    Timer(timeout);
+    block();
+    cur_routine->timer = 0;
+}
+
+uint32_t Engine::wait(int fd, uint32_t events, std::chrono::milliseconds timeout) {
+    if (current() == nullptr) {
+        return 0;
+    }
+
+    if (epoll_fd == -1) {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+    }
+
+    // Descriptor stays registered after one shot event, so usually it is just rearmed
+    struct epoll_event event;
+    event.events = events | EPOLLONESHOT;
+    event.data.ptr = cur_routine;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) != 0 &&
+        (errno != ENOENT || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)) {
+        throw std::runtime_error("Failed to add descriptor to epoll: " + std::string(strerror(errno)));
+    }
+
+    cur_routine->events = 0;
+    io_waiters++;
+    if (timeout.count() >= 0) {
+        Timer(timeout);
+    }
+    block();
+
+    // Timer or someone else unblocked routine, descriptor is still armed and must not wake it later
+    context *ctx = cur_routine;
+    ctx->timer = 0;
+    if (ctx->events == 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &event);
+        io_waiters--;
+    }
+
+    uint32_t result = ctx->events;
+    ctx->events = 0;
+    return result;
+}
+
 void Engine::Store(context &ctx) {
     char cur_address;
     ctx.Hight = &cur_address;
@@ -18,13 +254,14 @@ void Engine::Store(context &ctx) {
         ctx.Low = tmp;
     }
 
-    if (std::get<0>(ctx.Stack) != nullptr) {
-        delete std::get<0>(ctx.Stack);
-    }
+    // Buffer is reused while stack doesn't grow
     std::size_t length = ctx.Hight - ctx.Low;
-    char *stack = new char[length];
-    std::memcpy(stack, ctx.Low, length);
-    ctx.Stack = std::make_tuple(stack, length);
+    if (std::get<1>(ctx.Stack) < length) {
+        delete[] std::get<0>(ctx.Stack);
+        std::get<0>(ctx.Stack) = new char[length];
+        std::get<1>(ctx.Stack) = length;
+    }
+    std::memcpy(std::get<0>(ctx.Stack), ctx.Low, length);
 }
 
 void Engine::Restore(context &ctx) {
@@ -34,29 +271,51 @@ void Engine::Restore(context &ctx) {
         Restore(ctx);
     }
 
-    std::memcpy(ctx.Low, std::get<0>(ctx.Stack), std::get<1>(ctx.Stack));
+    std::memcpy(ctx.Low, std::get<0>(ctx.Stack), ctx.Hight - ctx.Low);
     cur_routine = &ctx;
     // TOASK: any number except 0?
     longjmp(ctx.Environment, 1);
 }
 
 void Engine::yield() {
-    Store(*cur_routine);
-    auto routine_todo = alive;
-    if (routine_todo == cur_routine) {
-        if (alive->next != nullptr) {
-            routine_todo = alive->next;
-            sched(static_cast<void *>(routine_todo));
-        }
+    // Routines might never give control to idle one, so it is their job to check whether anyone is ready
+    if ((io_waiters > 0 || !timers.empty()) && std::chrono::steady_clock::now() - last_poll >= poll_interval) {
+        Poll(0);
+    }
+
+    // Alive routines take turns: the one next to current, or the first one once the end of list is reached
+    context *routine_todo = nullptr;
+    if (cur_routine != nullptr && cur_routine != idle_ctx && !cur_routine->blocked) {
+        routine_todo = cur_routine->next;
+    }
+    if (routine_todo == nullptr) {
+        routine_todo = alive;
+    }
+    if (routine_todo != nullptr && routine_todo != cur_routine) {
+        sched(static_cast<void *>(routine_todo));
     }
 }
 
 void Engine::sched(void *routine_) {
-    if (setjmp(cur_routine->Environment) == 0) {
+    if (routine_ == nullptr) {
+        yield();
+        return;
+    }
+
+    // Blocked routine waits for unblock
+    context *ctx = static_cast<context *>(routine_);
+    if (ctx == cur_routine || ctx->blocked) {
+        return;
+    }
+
+    // Routine that has just finished has nothing to save
+    if (cur_routine != nullptr) {
+        if (setjmp(cur_routine->Environment) > 0) {
+            return;
+        }
         Store(*cur_routine);
-        context *ctx = static_cast<context *>(routine_);
-        Restore(*ctx);
     }
+    Restore(*ctx);
 }
 
 } // namespace Coroutine
@@ -0,0 +1,43 @@
+#include <afina/coroutine/Mutex.h>
+
+namespace Afina {
+namespace Coroutine {
+
+// See Mutex.h
+void Mutex::lock() {
+    void *self = _engine.current();
+    if (_owner == nullptr) {
+        _owner = self;
+        return;
+    }
+
+    // Lock is handed over in unlock, no one could take it in between
+    _waiters.push_back(self);
+    while (_owner != self) {
+        _engine.block();
+    }
+}
+
+// See Mutex.h
+bool Mutex::try_lock() {
+    if (_owner != nullptr) {
+        return false;
+    }
+    _owner = _engine.current();
+    return true;
+}
+
+// See Mutex.h
+void Mutex::unlock() {
+    if (_waiters.empty()) {
+        _owner = nullptr;
+        return;
+    }
+
+    _owner = _waiters.front();
+    _waiters.pop_front();
+    _engine.unblock(_owner);
+}
+
+} // namespace Coroutine
+} // namespace Afina
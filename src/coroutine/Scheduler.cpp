@@ -0,0 +1,384 @@
+#include <afina/coroutine/Scheduler.h>
+
+#include <thread>
+
+#include <afina/concurrency/WorkStealingDeque.h>
+
+#include "Context.h"
+
+namespace Afina {
+namespace Coroutine {
+
+namespace {
+
+// Routine states: queued, executed by worker, executed with unblock already received, waiting for unblock
+const int Ready = 0;
+const int Running = 1;
+const int Notified = 2;
+const int Blocked = 3;
+
+// What routine asks its worker to do once it gets control back
+const int Yield = 1;
+const int Block = 2;
+const int Finish = 3;
+
+// Worker checks global queue first every that many routines, so yielded ones can't starve
+const uint64_t global_check_interval = 61;
+
+} // namespace
+
+struct Scheduler::routine {
+    Registers regs;
+
+    // Whole mapping, guard page included
+    char *stack = nullptr;
+    std::size_t size = 0;
+
+    Call *body = nullptr;
+    std::atomic<int> state;
+
+    // Worker routine has been running on last time
+    std::size_t worker = 0;
+
+    // To keep routine in the pool
+    routine *prev = nullptr;
+    routine *next = nullptr;
+};
+
+struct Scheduler::worker {
+    worker(Scheduler &s, std::size_t i, std::size_t pool_size)
+        : owner(s), index(i), current(nullptr), action(0), ticks(0), seed(i + 1), pool(pool_size) {}
+
+    Scheduler &owner;
+    std::size_t index;
+
+    Concurrency::WorkStealingDeque<routine> queue;
+
+    // Thread stack of worker, routine switches back there
+    Registers idle;
+    routine *current;
+    int action;
+
+    // Routines run so far and state of victim selection
+    uint64_t ticks;
+    uint32_t seed;
+
+    Pool<routine> pool;
+    std::thread thread;
+};
+
+namespace {
+
+// Worker of the calling thread. Code running in routine must not cache its address across switches
+thread_local void *this_worker = nullptr;
+
+} // namespace
+
+// See Scheduler.h
+Scheduler::Scheduler(std::size_t threads, std::size_t stack_size, std::size_t pool_size)
+    : _threads(threads == 0 ? 1 : threads), _stack_size(stack_size), _pool_size(pool_size), _running(false), _live(0),
+      _global_size(0), _sleeping(0), _steals(0), _migrations(0), _spawned(0) {}
+
+// See Scheduler.h
+Scheduler::~Scheduler() {}
+
+// See Scheduler.h
+void Scheduler::Start(Call *main) {
+    bool expected = false;
+    if (!_running.compare_exchange_strong(expected, true)) {
+        delete main;
+        return;
+    }
+
+    _steals = _migrations = _spawned = 0;
+    _pool_stats = PoolStats();
+    for (std::size_t i = 0; i < _threads; i++) {
+        _workers.emplace_back(new worker(*this, i, _pool_size));
+    }
+
+    if (Spawn(main) != nullptr) {
+        for (std::size_t i = 1; i < _threads; i++) {
+            _workers[i]->thread = std::thread(&Scheduler::Run, this, std::ref(*_workers[i]));
+        }
+        Run(*_workers[0]);
+        for (std::size_t i = 1; i < _threads; i++) {
+            _workers[i]->thread.join();
+        }
+    }
+
+    // Everything is done, stacks in the pools are not needed anymore
+    for (auto &w : _workers) {
+        _pool_stats.hits += w->pool.Stats().hits;
+        _pool_stats.misses += w->pool.Stats().misses;
+        for (routine *r = w->pool.Pop(); r != nullptr; r = w->pool.Pop()) {
+            UnmapStack(r->stack, r->size);
+            delete r;
+        }
+    }
+    _workers.clear();
+    _running.store(false, std::memory_order_release);
+}
+
+// See Scheduler.h
+void *Scheduler::Spawn(Call *body) {
+    worker *w = Current();
+    routine *r = w != nullptr ? w->pool.Get() : nullptr;
+    if (r == nullptr) {
+        std::size_t size = _stack_size;
+        char *stack = MapStack(size);
+        if (stack == nullptr) {
+            delete body;
+            return nullptr;
+        }
+
+        r = new routine();
+        r->stack = stack;
+        r->size = size;
+    }
+    r->body = body;
+    r->state.store(Ready, std::memory_order_relaxed);
+    r->worker = w != nullptr ? w->index : 0;
+    Prepare(r->regs, r->stack, r->size, &Scheduler::Enter, r);
+
+    _live.fetch_add(1);
+    _spawned.fetch_add(1, std::memory_order_relaxed);
+    Schedule(r);
+    return r;
+}
+
+// See Scheduler.h
+void Scheduler::Run(worker &w) {
+    this_worker = &w;
+    for (;;) {
+        routine *r = Next(w);
+        if (r == nullptr) {
+            if (_live.load() == 0) {
+                break;
+            }
+            Park();
+            continue;
+        }
+
+        // Unblock might have come already, routine keeps it
+        int state = Ready;
+        r->state.compare_exchange_strong(state, Running);
+        if (r->worker != w.index) {
+            _migrations.fetch_add(1, std::memory_order_relaxed);
+            r->worker = w.index;
+        }
+
+        w.current = r;
+        w.action = 0;
+        Swap(w.idle, r->regs);
+        w.current = nullptr;
+
+        // Routine registers are saved by now, so it is safe to let others resume it
+        switch (w.action) {
+        case Yield:
+            state = Running;
+            r->state.compare_exchange_strong(state, Ready);
+            ScheduleGlobal(r);
+            break;
+
+        case Block:
+            for (;;) {
+                state = r->state.load();
+                if (state == Running && r->state.compare_exchange_weak(state, Blocked)) {
+                    break;
+                } else if (state == Notified) {
+                    // Unblocked before it got suspended
+                    r->state.store(Ready);
+                    Schedule(r);
+                    break;
+                }
+            }
+            break;
+
+        case Finish:
+            if (!w.pool.Put(r)) {
+                UnmapStack(r->stack, r->size);
+                delete r;
+            }
+            if (_live.fetch_sub(1) == 1) {
+                // The last one, everybody can go
+                std::lock_guard<std::mutex> lock(_lock);
+                _wakeup.notify_all();
+            }
+            break;
+        }
+    }
+    this_worker = nullptr;
+}
+
+// See Scheduler.h
+Scheduler::routine *Scheduler::Next(worker &w) {
+    routine *r = nullptr;
+    if (++w.ticks % global_check_interval == 0 || (r = w.queue.Pop()) == nullptr) {
+        if (_global_size.load() > 0) {
+            std::lock_guard<std::mutex> lock(_lock);
+            if (!_global.empty()) {
+                r = _global.front();
+                _global.pop_front();
+                _global_size.fetch_sub(1);
+            }
+        }
+    }
+    if (r == nullptr) {
+        r = w.queue.Pop();
+    }
+    if (r != nullptr) {
+        return r;
+    }
+
+    // Steal starting from random victim, so that thieves don't all go after the same one
+    w.seed ^= w.seed << 13;
+    w.seed ^= w.seed >> 17;
+    w.seed ^= w.seed << 5;
+    for (std::size_t i = 0; i < _workers.size(); i++) {
+        worker &victim = *_workers[(w.seed + i) % _workers.size()];
+        if (&victim == &w) {
+            continue;
+        }
+        r = victim.queue.Steal();
+        if (r != nullptr) {
+            _steals.fetch_add(1, std::memory_order_relaxed);
+            return r;
+        }
+    }
+    return nullptr;
+}
+
+// See Scheduler.h
+void Scheduler::Park() {
+    std::unique_lock<std::mutex> lock(_lock);
+    _sleeping.fetch_add(1);
+
+    // Pair to the fence in Notify: either queue owner sees sleeper or sleeper sees routine in the queue
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!HasWork() && _live.load() > 0) {
+        _wakeup.wait(lock);
+    }
+    _sleeping.fetch_sub(1);
+}
+
+// See Scheduler.h
+bool Scheduler::HasWork() {
+    if (!_global.empty()) {
+        return true;
+    }
+    for (auto &w : _workers) {
+        if (w->queue.Size() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// See Scheduler.h
+void Scheduler::Schedule(routine *r) {
+    worker *w = Current();
+    if (w == nullptr) {
+        ScheduleGlobal(r);
+        return;
+    }
+    w->queue.Push(r);
+    Notify();
+}
+
+// See Scheduler.h
+void Scheduler::ScheduleGlobal(routine *r) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _global.push_back(r);
+    _global_size.fetch_add(1);
+    if (_sleeping.load() > 0) {
+        _wakeup.notify_one();
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(_lock);
+        _wakeup.notify_one();
+    }
+}
+
+// See Scheduler.h
+__attribute__((noinline)) Scheduler::worker *Scheduler::Current() const {
+    // Barrier keeps compiler from reusing address of thread local computed before switch
+    asm volatile("" ::: "memory");
+    worker *w = static_cast<worker *>(this_worker);
+    if (w == nullptr || &w->owner != this) {
+        return nullptr;
+    }
+    return w;
+}
+
+// See Scheduler.h
+void Scheduler::Suspend(int action) {
+    worker *w = Current();
+    if (w == nullptr || w->current == nullptr) {
+        return;
+    }
+    w->action = action;
+    Swap(w->current->regs, w->idle);
+}
+
+// See Scheduler.h
+void Scheduler::Enter(void *arg) {
+    routine *r = static_cast<routine *>(arg);
+    (*r->body)();
+    delete r->body;
+    r->body = nullptr;
+
+    // Worker frees stack once it is not in use, control never comes back here
+    worker *w = static_cast<worker *>(this_worker);
+    w->owner.Suspend(Finish);
+}
+
+// See Scheduler.h
+void Scheduler::yield() { Suspend(Yield); }
+
+// See Scheduler.h
+void Scheduler::block() { Suspend(Block); }
+
+// See Scheduler.h
+void Scheduler::unblock(void *routine_) {
+    routine *r = static_cast<routine *>(routine_);
+    for (;;) {
+        int state = r->state.load();
+        if (state == Blocked) {
+            if (r->state.compare_exchange_weak(state, Ready)) {
+                Schedule(r);
+                return;
+            }
+        } else if (state == Running) {
+            // Routine is about to block, it won't
+            if (r->state.compare_exchange_weak(state, Notified)) {
+                return;
+            }
+        } else {
+            return;
+        }
+    }
+}
+
+// See Scheduler.h
+void *Scheduler::current() const {
+    worker *w = Current();
+    return w != nullptr ? w->current : nullptr;
+}
+
+// See Scheduler.h
+SchedulerStats Scheduler::stats() const {
+    SchedulerStats result;
+    result.steals = _steals.load(std::memory_order_relaxed);
+    result.migrations = _migrations.load(std::memory_order_relaxed);
+    result.spawned = _spawned.load(std::memory_order_relaxed);
+    result.pool = _pool_stats;
+    return result;
+}
+
+} // namespace Coroutine
+} // namespace Afina
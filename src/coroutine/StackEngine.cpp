@@ -0,0 +1,168 @@
+#include <afina/coroutine/StackEngine.h>
+
+#include "Context.h"
+
+namespace Afina {
+namespace Coroutine {
+
+struct StackEngine::context {
+    Registers regs;
+
+    // Whole mapping, guard page included. Thread stack of idle context has none
+    char *stack = nullptr;
+    std::size_t size = 0;
+
+    Call *body = nullptr;
+    StackEngine *engine = nullptr;
+
+    // To include routine in the different lists, such as "alive", "blocked", e.t.c
+    context *prev = nullptr;
+    context *next = nullptr;
+};
+
+// See StackEngine.h
+StackEngine::StackEngine(std::size_t stack_size, std::size_t pool_size)
+    : _stack_size(stack_size), idle_ctx(nullptr), cur_routine(nullptr), alive(nullptr), finished(nullptr),
+      pool(pool_size), started(false) {}
+
+// See StackEngine.h
+StackEngine::~StackEngine() {
+    Reap();
+    for (context *pc = pool.Pop(); pc != nullptr; pc = pool.Pop()) {
+        UnmapStack(pc->stack, pc->size);
+        delete pc;
+    }
+}
+
+// See StackEngine.h
+void *StackEngine::Spawn(Call *body) {
+    context *pc = pool.Get();
+    if (pc == nullptr) {
+        std::size_t size = _stack_size;
+        char *stack = MapStack(size);
+        if (stack == nullptr) {
+            delete body;
+            return nullptr;
+        }
+
+        pc = new context();
+        pc->stack = stack;
+        pc->size = size;
+        pc->engine = this;
+    }
+    pc->body = body;
+    Prepare(pc->regs, pc->stack, pc->size, &StackEngine::Enter, pc);
+
+    // Add routine as alive double-linked list
+    pc->next = alive;
+    alive = pc;
+    if (pc->next != nullptr) {
+        pc->next->prev = pc;
+    }
+    return pc;
+}
+
+// See StackEngine.h
+void StackEngine::Loop(void *main) {
+    context idle;
+    idle.engine = this;
+    idle_ctx = &idle;
+    cur_routine = idle_ctx;
+
+    if (main != nullptr) {
+        sched(main);
+    }
+    while (alive != nullptr) {
+        yield();
+    }
+
+    cur_routine = nullptr;
+    idle_ctx = nullptr;
+}
+
+// See StackEngine.h
+void StackEngine::Switch(context &ctx) {
+    context *from = cur_routine;
+    cur_routine = &ctx;
+    Swap(from->regs, ctx.regs);
+
+    // Here: someone switched back to this routine, may be the one that has just finished
+    Reap();
+}
+
+// See StackEngine.h
+void StackEngine::Reap() {
+    if (finished != nullptr) {
+        Release(finished);
+        finished = nullptr;
+    }
+}
+
+// See StackEngine.h
+void StackEngine::Release(context *pc) {
+    // Stack is dirty, but routine starts from a frame prepared on its top anyway
+    if (!pool.Put(pc)) {
+        UnmapStack(pc->stack, pc->size);
+        delete pc;
+    }
+}
+
+// See StackEngine.h
+void StackEngine::Enter(void *arg) {
+    context *pc = static_cast<context *>(arg);
+    StackEngine &engine = *pc->engine;
+
+    // First switch into routine doesn't return through Switch
+    engine.Reap();
+    (*pc->body)();
+    delete pc->body;
+    pc->body = nullptr;
+
+    // Routine has completed its execution, remove it from alive list
+    if (pc->prev != nullptr) {
+        pc->prev->next = pc->next;
+    }
+    if (pc->next != nullptr) {
+        pc->next->prev = pc->prev;
+    }
+    if (engine.alive == pc) {
+        engine.alive = pc->next;
+    }
+    pc->prev = pc->next = nullptr;
+
+    // Stack is still in use, whoever gets control frees it. Scheduler keeps running the rest
+    engine.finished = pc;
+    engine.Switch(*engine.idle_ctx);
+}
+
+// See StackEngine.h
+void StackEngine::yield() {
+    // Alive routines take turns: the one next to current, or the first one once the end of list is reached
+    context *routine_todo = nullptr;
+    if (cur_routine != nullptr && cur_routine != idle_ctx) {
+        routine_todo = cur_routine->next;
+    }
+    if (routine_todo == nullptr) {
+        routine_todo = alive;
+    }
+    if (routine_todo != nullptr && routine_todo != cur_routine) {
+        sched(static_cast<void *>(routine_todo));
+    }
+}
+
+// See StackEngine.h
+void StackEngine::sched(void *routine_) {
+    if (routine_ == nullptr) {
+        yield();
+        return;
+    }
+
+    context *ctx = static_cast<context *>(routine_);
+    if (ctx == cur_routine) {
+        return;
+    }
+    Switch(*ctx);
+}
+
+} // namespace Coroutine
+} // namespace Afina
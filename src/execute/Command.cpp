@@ -1 +1,22 @@
 #include <afina/execute/Command.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Command.h
+void Command::Execute(Storage &storage, const std::string &args, Chunks &out) {
+    std::shared_ptr<std::string> result = std::make_shared<std::string>();
+    Execute(storage, args, *result);
+    out.push_back(std::move(result));
+}
+
+// See Command.h
+void Command::Execute(Storage &storage, const std::string &args, Output &out) {
+    // Short responses fit into the string itself, so nothing is allocated
+    std::string result;
+    Execute(storage, args, result);
+    out.Append(result.data(), result.size());
+}
+
+} // namespace Execute
+} // namespace Afina
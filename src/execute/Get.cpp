@@ -1,9 +1,7 @@
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
 
-#include <iostream>
-#include <iterator>
-#include <sstream>
+#include <cstdio>
 
 namespace Afina {
 namespace Execute {
@@ -22,22 +20,50 @@ to indicate the end of response.
 */
 
 void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::stringstream keyStream;
-    copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
-    std::cout << "Get(" << keyStream.str() << ")" << std::endl;
+    Chunks chunks;
+    Execute(storage, args, chunks);
 
-    std::stringstream outStream;
+    std::size_t size = 0;
+    for (auto &chunk : chunks) {
+        size += chunk->size();
+    }
+    out.clear();
+    out.reserve(size);
+    for (auto &chunk : chunks) {
+        out += *chunk;
+    }
+}
+
+void Get::Execute(Storage &storage, const std::string &args, Chunks &out) {
+    static const std::shared_ptr<const std::string> value_end = std::make_shared<const std::string>("\r\n");
+    static const std::shared_ptr<const std::string> end = std::make_shared<const std::string>("END");
 
-    std::string value;
+    std::shared_ptr<const std::string> value;
     for (auto &key : _keys) {
-        if (!storage.Get(key, value))
+        if (!storage.GetView(key, value))
             continue;
-        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
-        outStream << value << "\r\n";
+        std::string header = "VALUE " + key + " 0 " + std::to_string(value->size()) + "\r\n";
+        out.push_back(std::make_shared<const std::string>(std::move(header)));
+        out.push_back(std::move(value));
+        out.push_back(value_end);
     }
-    outStream << "END"; // networking layer should add the last \r\n
+    out.push_back(end); // networking layer should add the last \r\n
+}
 
-    out = outStream.str();
+void Get::Execute(Storage &storage, const std::string &args, Output &out) {
+    std::shared_ptr<const std::string> value;
+    for (auto &key : _keys) {
+        if (!storage.GetView(key, value))
+            continue;
+        char size[32];
+        int size_len = std::snprintf(size, sizeof(size), " 0 %zu\r\n", value->size());
+        out.Append("VALUE ", 6);
+        out.Append(key.data(), key.size());
+        out.Append(size, size_len);
+        out.Append(std::move(value));
+        out.Append("\r\n", 2);
+    }
+    out.Append("END", 3); // networking layer should add the last \r\n
 }
 
 } // namespace Execute
@@ -1,27 +1,47 @@
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <memory>
 
 #include <atomic>
+#include <fcntl.h>
+#include <poll.h>
 #include <semaphore.h>
 #include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 #include <cxxopts.hpp>
 
 #include <afina/Storage.h>
 #include <afina/Version.h>
+#include <afina/coroutine/Engine.h>
 #include <afina/logging/Service.h>
 #include <afina/network/Server.h>
 
 #include "logging/ServiceImpl.h"
+#include "network/Handoff.h"
 #include "network/mt_blocking/ServerImpl.h"
 #include "network/mt_nonblocking/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
+#include "network/st_coroutine/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
-
+#include "network/uring/ServerImpl.h"
+
+#include "storage/ClockCache.h"
+#include "storage/FlatCombineLRU.h"
+#include "storage/HashLRU.h"
+#include "storage/ReadMostlyLRU.h"
+#include "storage/ShardedLRU.h"
+#include "storage/SlabLRU.h"
 #include "storage/SimpleLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina;
 
@@ -50,10 +70,40 @@ public:
             storage_type = options["storage"].as<std::string>();
         }
 
+        // Memory budget of storage: maximum size of all keys and values in bytes
+        size_t storage_size = 1024;
+        if (options.count("storage_size") > 0) {
+            storage_size = options["storage_size"].as<size_t>();
+        }
+
         if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
+            storage = std::make_shared<Afina::Backend::SimpleLRU>(storage_size);
         } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(storage_size);
+        } else if (storage_type == "fc_lru") {
+            storage = std::make_shared<Afina::Backend::FlatCombineLRU>(storage_size);
+        } else if (storage_type == "st_lru_hash") {
+            storage = std::make_shared<Afina::Backend::HashLRU>(storage_size);
+        } else if (storage_type == "st_lru_slab") {
+            storage = std::make_shared<Afina::Backend::SlabLRU>(storage_size);
+        } else if (storage_type == "rw_lru") {
+            storage = std::make_shared<Afina::Backend::ReadMostlyLRU>(storage_size);
+        } else if (storage_type == "clock") {
+            storage = std::make_shared<Afina::Backend::ClockCache>(storage_size);
+        } else if (storage_type == "tinylfu") {
+            storage = std::make_shared<Afina::Backend::TinyLFU>(storage_size);
+        } else if (storage_type == "sharded_lru") {
+            // Default is cut down by storage itself if budget is too small, explicit one is checked here
+            size_t shards = std::thread::hardware_concurrency();
+            if (options.count("shards") > 0) {
+                shards = options["shards"].as<size_t>();
+                if (shards > 1 && storage_size / shards < Afina::Backend::ShardedLRU::min_slice) {
+                    throw std::runtime_error("Partitions of sharded storage must be at least " +
+                                             std::to_string(Afina::Backend::ShardedLRU::min_slice) +
+                                             " bytes, increase storage_size or decrease shards");
+                }
+            }
+            storage = std::make_shared<Afina::Backend::ShardedLRU>(storage_size, shards);
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -64,14 +114,59 @@ public:
             network_type = options["network"].as<std::string>();
         }
 
+        // Option is in seconds, 0 means connection could stay idle forever
+        uint32_t idle_timeout = 0;
+        if (options.count("idle_timeout") > 0) {
+            idle_timeout = options["idle_timeout"].as<uint32_t>() * 1000;
+        }
+
+        // Time to write out responses on stop, in seconds as well
+        uint32_t drain_timeout = 5000;
+        if (options.count("drain_timeout") > 0) {
+            drain_timeout = options["drain_timeout"].as<uint32_t>() * 1000;
+        }
+
         if (network_type == "st_block") {
             server = std::make_shared<Afina::Network::STblocking::ServerImpl>(storage, logService);
         } else if (network_type == "mt_block") {
-            server = std::make_shared<Afina::Network::MTblocking::ServerImpl>(storage, logService);
+            // Connection occupies pool thread until it is closed, low watermark threads are always ready
+            uint32_t pool_low = 2, pool_high = 16, pool_queue = 64, pool_idle = 10000;
+            if (options.count("pool_low") > 0) {
+                pool_low = options["pool_low"].as<uint32_t>();
+            }
+            if (options.count("pool_high") > 0) {
+                pool_high = options["pool_high"].as<uint32_t>();
+            }
+            if (options.count("pool_queue") > 0) {
+                pool_queue = options["pool_queue"].as<uint32_t>();
+            }
+            if (options.count("pool_idle") > 0) {
+                pool_idle = options["pool_idle"].as<uint32_t>() * 1000;
+            }
+            server = std::make_shared<Afina::Network::MTblocking::ServerImpl>(storage, logService, pool_low, pool_high,
+                                                                              pool_queue, pool_idle);
         } else if (network_type == "st_nonblock") {
-            server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
+            server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService, idle_timeout);
+        } else if (network_type == "st_coroutine") {
+            // Finished connection coroutines are kept for new connections to reuse
+            std::size_t coroutine_pool = Afina::Coroutine::Engine::default_pool_size;
+            if (options.count("coroutine_pool") > 0) {
+                coroutine_pool = options["coroutine_pool"].as<uint32_t>();
+            }
+            server = std::make_shared<Afina::Network::STcoroutine::ServerImpl>(storage, logService, coroutine_pool);
         } else if (network_type == "mt_nonblock") {
-            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+            bool reuseport = options.count("reuseport") > 0;
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService, reuseport,
+                                                                              idle_timeout, drain_timeout);
+        } else if (network_type == "uring") {
+            if (Afina::Network::Uring::ServerImpl::Supported()) {
+                server = std::make_shared<Afina::Network::Uring::ServerImpl>(storage, logService);
+            } else {
+                // Closest epoll server: per-worker sockets and no cross-thread handoff as well
+                std::cerr << "io_uring isn't available, fallback to mt_nonblock --reuseport" << std::endl;
+                server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService, true,
+                                                                                  idle_timeout, drain_timeout);
+            }
         } else {
             throw std::runtime_error("Unknown network type");
         }
@@ -92,12 +187,148 @@ public:
         server->Start(port, 2, 2);
     }
 
+    // Listen on sockets of the previous process instead of opening new ones
+    void Inherit(int handoff_fd) { server->Inherit(Afina::Network::ReceiveDescriptors(handoff_fd)); }
+
+    /**
+     * Starts new process with the given command line and hands listening sockets over to it. Returns true once
+     * new process serves them, this one should stop then. Keeps serving and returns false if new process failed
+     */
+    bool Restart(const std::vector<std::string> &command_line) {
+        auto log = logService->select("root");
+        std::vector<int> sockets = server->Sockets();
+        if (sockets.empty()) {
+            log->error("Network service can't hand its sockets over, restart is refused");
+            return false;
+        }
+
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) == -1) {
+            log->error("Failed to create handoff socket: {}", strerror(errno));
+            return false;
+        }
+
+        // Everything new process needs is prepared in advance, child of threaded process may not allocate
+        std::vector<std::string> args(command_line);
+        args.push_back("--handoff_fd");
+        args.push_back(std::to_string(handoff_fd));
+        std::vector<char *> argv;
+        for (auto &arg : args) {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+
+        log->warn("Restart: start {}", args[0]);
+        pid_t pid = fork();
+        if (pid == -1) {
+            log->error("Failed to fork: {}", strerror(errno));
+            close(pair[0]);
+            close(pair[1]);
+            return false;
+        } else if (pid == 0) {
+            // Handoff socket goes to the well known descriptor, the rest is not inherited
+            if (pair[1] == handoff_fd) {
+                fcntl(handoff_fd, F_SETFD, 0);
+            } else {
+                dup2(pair[1], handoff_fd);
+            }
+            if (syscall(SYS_close_range, handoff_fd + 1, ~0U, 0) == -1) {
+                for (int fd = handoff_fd + 1; fd < 65536; fd++) {
+                    close(fd);
+                }
+            }
+            sigset_t sig_mask;
+            sigemptyset(&sig_mask);
+            sigprocmask(SIG_SETMASK, &sig_mask, nullptr);
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+        close(pair[1]);
+
+        // New process reports once it has started, or closes the socket if it failed
+        char ready = 0;
+        bool started = false;
+        try {
+            Afina::Network::SendDescriptors(pair[0], sockets);
+
+            struct pollfd pfd;
+            pfd.fd = pair[0];
+            pfd.events = POLLIN;
+            if (poll(&pfd, 1, restart_timeout) == 1 && read(pair[0], &ready, 1) == 1) {
+                started = true;
+            }
+        } catch (std::runtime_error &ex) {
+            log->error("Restart: {}", ex.what());
+        }
+
+        if (!started) {
+            log->error("Restart: new process {} failed to start, keep serving", pid);
+            close(pair[0]);
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+            return false;
+        }
+        log->warn("Restart: process {} serves now, drain and exit", pid);
+
+        // Idle connections follow on stop
+        handoffSocket = pair[0];
+        server->HandOver(handoffSocket);
+        return true;
+    }
+
+    // Lets previous process go
+    void Started(int handoff_fd) {
+        char ready = 1;
+        if (write(handoff_fd, &ready, 1) != 1) {
+            throw std::runtime_error("Failed to notify previous process");
+        }
+    }
+
+    // Serves idle connections of the previous process until it closes handoff socket
+    void Adopt(int handoff_fd) {
+        auto log = logService->select("root");
+        std::size_t adopted = 0, dropped = 0;
+        try {
+            for (auto sockets = Afina::Network::ReceiveDescriptors(handoff_fd); !sockets.empty();
+                 sockets = Afina::Network::ReceiveDescriptors(handoff_fd)) {
+                for (int socket : sockets) {
+                    switch (server->Adopt(socket)) {
+                    case Afina::Network::Adoption::Adopted:
+                        adopted++;
+                        break;
+                    case Afina::Network::Adoption::Dropped:
+                        // Server has closed it already
+                        dropped++;
+                        break;
+                    case Afina::Network::Adoption::Refused:
+                        close(socket);
+                        dropped++;
+                        break;
+                    }
+                }
+            }
+        } catch (std::runtime_error &ex) {
+            log->error("Failed to adopt connections: {}", ex.what());
+        }
+        close(handoff_fd);
+        log->warn("Adopted {} connections of the previous process, {} dropped", adopted, dropped);
+    }
+
+    // Descriptor new process gets handoff socket on
+    static const int handoff_fd = 3;
+
+    // Milliseconds new process has to start
+    static const int restart_timeout = 10000;
+
     // Stop services in correct order
     void Stop() {
         auto log = logService->select("root");
         log->warn("Stop application");
         server->Stop();
         server->Join();
+        if (handoffSocket != -1) {
+            close(handoffSocket);
+        }
 
         storage->Stop();
         logService->Stop();
@@ -109,6 +340,9 @@ private:
 
     std::shared_ptr<Afina::Storage> storage;
     std::shared_ptr<Afina::Network::Server> server;
+
+    // New process connections are handed over to, see Restart
+    int handoffSocket = -1;
 };
 
 // Signal set that to notify application about time to stop
@@ -122,13 +356,43 @@ void on_term(int signum, siginfo_t *siginfo, void *data) {
 }
 
 int main(int argc, char **argv) {
+    // Restart runs new process with the same command line, parser is going to consume it
+    std::vector<std::string> command_line;
+    for (int i = 0; i < argc; i++) {
+        if (std::string(argv[i]) == "--handoff_fd") {
+            i++;
+        } else if (std::string(argv[i]).compare(0, 13, "--handoff_fd=") != 0) {
+            command_line.push_back(argv[i]);
+        }
+    }
+
     // Command line arguments parsing
     cxxopts::Options options("afina", "Simple memory caching server");
     try {
         // TODO: use custom cxxopts::value to print options possible values in help message
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
+        options.add_options()("storage_size", "Storage memory budget in bytes", cxxopts::value<size_t>());
+        options.add_options()("shards",
+                              "Number of partitions for sharded storage, each gets storage_size / shards bytes (at "
+                              "least 4096) and key plus value must fit into one partition",
+                              cxxopts::value<size_t>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
+        options.add_options()("reuseport", "Give every mt_nonblock worker own listening socket and epoll");
+        options.add_options()("idle_timeout", "Seconds before idle connection of non blocking server is closed",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("drain_timeout", "Seconds mt_nonblock server writes out responses on stop",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("pool_low", "Threads mt_block pool keeps ready", cxxopts::value<uint32_t>());
+        options.add_options()("pool_high", "Most threads mt_block pool runs", cxxopts::value<uint32_t>());
+        options.add_options()("pool_queue", "Connections waiting for mt_block pool thread before new ones are refused",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("pool_idle", "Seconds extra mt_block pool thread waits for connection before it exits",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("coroutine_pool", "Contexts of finished st_coroutine connections kept for reuse",
+                              cxxopts::value<uint32_t>());
+        options.add_options()("handoff_fd", "Descriptor to get listening sockets from, used by restart",
+                              cxxopts::value<int>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
 
@@ -161,16 +425,38 @@ int main(int argc, char **argv) {
 
         sigaction(SIGINT, &act, NULL);
         sigaction(SIGTERM, &act, NULL);
+
+        // Restart with the new binary
+        sigaction(SIGUSR2, &act, NULL);
     }
 
     // Run app
     try {
-        // Start services
-        app.Start();
+        // Start services, on sockets of the previous process if that is restart
+        if (options.count("handoff_fd") > 0) {
+            int handoff_fd = options["handoff_fd"].as<int>();
+            app.Inherit(handoff_fd);
+            app.Start();
+            app.Started(handoff_fd);
+            app.Adopt(handoff_fd);
+        } else {
+            app.Start();
+        }
 
         // Freeze main thread until one of signals arrive
-        while (stop_reason == 0 && ((sem_wait(&stop_semaphore) == -1) && (errno == EINTR))) {
-            continue;
+        for (;;) {
+            while (stop_reason == 0 && ((sem_wait(&stop_semaphore) == -1) && (errno == EINTR))) {
+                continue;
+            }
+            if (stop_reason != SIGUSR2) {
+                break;
+            }
+
+            // New process accepts connections from now on, this one drains existing ones
+            stop_reason = 0;
+            if (app.Restart(command_line)) {
+                break;
+            }
         }
 
         // Stop services
@@ -0,0 +1,101 @@
+#include "Handoff.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+
+// See Handoff.h
+void SendDescriptors(int socket, const std::vector<int> &fds) {
+    if (fds.empty() || fds.size() > max_handoff) {
+        throw std::runtime_error("Unable to send " + std::to_string(fds.size()) + " descriptors");
+    }
+
+    // Count goes as data, message must carry at least one byte anyway
+    uint8_t count = fds.size();
+    struct iovec iov;
+    iov.iov_base = &count;
+    iov.iov_len = sizeof(count);
+
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * max_handoff)];
+        struct cmsghdr align;
+    } control;
+    std::memset(&control, 0, sizeof(control));
+
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+
+    ssize_t n;
+    while ((n = sendmsg(socket, &msg, MSG_NOSIGNAL)) == -1 && errno == EINTR) {
+    }
+    if (n != sizeof(count)) {
+        throw std::runtime_error("Failed to send descriptors: " + std::string(strerror(errno)));
+    }
+}
+
+// See Handoff.h
+std::vector<int> ReceiveDescriptors(int socket) {
+    uint8_t count = 0;
+    struct iovec iov;
+    iov.iov_base = &count;
+    iov.iov_len = sizeof(count);
+
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * max_handoff)];
+        struct cmsghdr align;
+    } control;
+
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t n;
+    while ((n = recvmsg(socket, &msg, MSG_CMSG_CLOEXEC)) == -1 && errno == EINTR) {
+    }
+    if (n == 0) {
+        return std::vector<int>();
+    } else if (n != sizeof(count)) {
+        throw std::runtime_error("Failed to receive descriptors: " + std::string(strerror(errno)));
+    }
+
+    std::vector<int> fds;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            std::size_t received = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const int *data = reinterpret_cast<const int *>(CMSG_DATA(cmsg));
+            fds.insert(fds.end(), data, data + received);
+        }
+    }
+
+    if (fds.size() != count || (msg.msg_flags & MSG_CTRUNC)) {
+        for (int fd : fds) {
+            close(fd);
+        }
+        throw std::runtime_error("Descriptors are lost on the way");
+    }
+    return fds;
+}
+
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,32 @@
+#ifndef AFINA_NETWORK_HANDOFF_H
+#define AFINA_NETWORK_HANDOFF_H
+
+#include <vector>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Passing sockets between processes
+ * Restart hands listening sockets of the running server over to the new process through UNIX socket, so that
+ * connections keep being accepted while the old one drains. Idle connections follow them once old one stops.
+ */
+
+// Most descriptors sent at once
+static const int max_handoff = 64;
+
+/**
+ * Sends descriptors as SCM_RIGHTS of a single message, throws std::runtime_error on failure
+ */
+void SendDescriptors(int socket, const std::vector<int> &fds);
+
+/**
+ * Receives descriptors sent by SendDescriptors, they are made close on exec. Returns empty vector once peer has closed
+ * the socket, throws std::runtime_error on failure
+ */
+std::vector<int> ReceiveDescriptors(int socket);
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_HANDOFF_H
@@ -0,0 +1,148 @@
+#include "OutputBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+
+namespace Afina {
+namespace Network {
+
+// Shared buffers shorter than that are copied, separate segment costs more than a copy then
+static const std::size_t min_shared = 1024;
+
+// Written out blocks kept for reuse
+static const std::size_t max_free = 4;
+
+#ifdef IOV_MAX
+static const std::size_t max_iov = IOV_MAX;
+#else
+static const std::size_t max_iov = 1024;
+#endif
+
+// See OutputBuffer.h
+OutputBuffer::OutputBuffer(std::size_t block_size)
+    : _block_size(block_size), _tail_used(0), _head_written(0), _size(0) {}
+
+// See OutputBuffer.h
+void OutputBuffer::Append(const char *data, std::size_t size) {
+    _size += size;
+    while (size > 0) {
+        if (_blocks.empty() || _tail_used == _block_size) {
+            AddBlock();
+        }
+
+        Block &tail = _blocks.back();
+        char *dst = tail.data.get() + _tail_used;
+        std::size_t n = std::min(size, _block_size - _tail_used);
+        std::memcpy(dst, data, n);
+        _tail_used += n;
+        data += n;
+        size -= n;
+
+        // Glue to the previous copy if there was nothing in between
+        if (!_segments.empty() && _segments.back().block == &tail &&
+            _segments.back().data + _segments.back().size == dst) {
+            _segments.back().size += n;
+        } else {
+            _segments.push_back(Segment{dst, n, &tail, nullptr});
+            tail.segments++;
+        }
+    }
+}
+
+// See OutputBuffer.h
+void OutputBuffer::Append(std::shared_ptr<const std::string> data) {
+    if (data->size() < min_shared) {
+        Append(data->data(), data->size());
+        return;
+    }
+
+    _size += data->size();
+    const char *p = data->data();
+    std::size_t size = data->size();
+    _segments.push_back(Segment{p, size, nullptr, std::move(data)});
+}
+
+// See OutputBuffer.h
+ssize_t OutputBuffer::WriteTo(int fd) {
+    _iov.clear();
+    for (auto it = _segments.begin(); it != _segments.end() && _iov.size() < max_iov; ++it) {
+        struct iovec iov;
+        iov.iov_base = const_cast<char *>(it->data);
+        iov.iov_len = it->size;
+        _iov.push_back(iov);
+    }
+    if (_iov.empty()) {
+        return 0;
+    }
+    _iov[0].iov_base = static_cast<char *>(_iov[0].iov_base) + _head_written;
+    _iov[0].iov_len -= _head_written;
+
+    ssize_t written = writev(fd, _iov.data(), _iov.size());
+    if (written > 0) {
+        Consume(written);
+    }
+    return written;
+}
+
+// See OutputBuffer.h
+void OutputBuffer::Clear() {
+    _segments.clear();
+    _head_written = 0;
+    _size = 0;
+    while (!_blocks.empty()) {
+        if (_free.size() < max_free) {
+            _free.push_back(std::move(_blocks.front().data));
+        }
+        _blocks.pop_front();
+    }
+    _tail_used = 0;
+}
+
+void OutputBuffer::Consume(std::size_t n) {
+    assert(n <= _size);
+    _size -= n;
+    n += _head_written;
+    while (n > 0 && n >= _segments.front().size) {
+        Segment &head = _segments.front();
+        n -= head.size;
+
+        // Blocks are filled and written in order, so the one written completely is the first
+        Block *block = head.block;
+        _segments.pop_front();
+        if (block != nullptr && --block->segments == 0) {
+            if (block != &_blocks.back()) {
+                assert(block == &_blocks.front());
+                if (_free.size() < max_free) {
+                    _free.push_back(std::move(block->data));
+                }
+                _blocks.pop_front();
+            } else {
+                // Tail is empty, fill it from the start again
+                _tail_used = 0;
+            }
+        }
+    }
+    _head_written = n;
+}
+
+void OutputBuffer::AddBlock() {
+    if (!_blocks.empty() && _blocks.back().segments == 0) {
+        _tail_used = 0;
+        return;
+    }
+
+    std::unique_ptr<char[]> data;
+    if (!_free.empty()) {
+        data = std::move(_free.back());
+        _free.pop_back();
+    } else {
+        data.reset(new char[_block_size]);
+    }
+    _blocks.push_back(Block{std::move(data), 0});
+    _tail_used = 0;
+}
+
+} // namespace Network
+} // namespace Afina
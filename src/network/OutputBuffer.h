@@ -0,0 +1,93 @@
+#ifndef AFINA_NETWORK_OUTPUT_BUFFER_H
+#define AFINA_NETWORK_OUTPUT_BUFFER_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/execute/Command.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Connection output buffer
+ * Responses of pipelined commands are appended one after another and written out together by a single writev.
+ *
+ * Small pieces are copied into a chain of fixed-size blocks, consecutive copies into the same block make up one
+ * segment of the output. Large values shared with storage are referenced instead, so they cost one more segment
+ * but no copy. Blocks that were written completely are kept for reuse, so a connection serving pipelined requests
+ * doesn't allocate memory per response.
+ */
+class OutputBuffer : public Execute::Output {
+public:
+    explicit OutputBuffer(std::size_t block_size = 4096);
+
+    // See Execute::Output
+    void Append(const char *data, std::size_t size) override;
+    void Append(std::shared_ptr<const std::string> data) override;
+
+    // Number of bytes waiting to be written
+    inline std::size_t Size() const { return _size; }
+    inline bool Empty() const { return _size == 0; }
+
+    /**
+     * Writes as much as possible with a single writev(2) call and drops written bytes. Returns result of writev
+     */
+    ssize_t WriteTo(int fd);
+
+    /**
+     * Drops all the data
+     */
+    void Clear();
+
+private:
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+
+        // Number of segments still pointing into the block
+        std::size_t segments;
+    };
+
+    struct Segment {
+        const char *data;
+        std::size_t size;
+
+        // Either block the data is copied to or buffer it is referenced from
+        Block *block;
+        std::shared_ptr<const std::string> shared;
+    };
+
+    // Drops n bytes from the front
+    void Consume(std::size_t n);
+
+    // Makes fresh tail block
+    void AddBlock();
+
+    const std::size_t _block_size;
+
+    // Blocks in use, tail one is filled by now
+    std::deque<Block> _blocks;
+    std::size_t _tail_used;
+    std::vector<std::unique_ptr<char[]>> _free;
+
+    std::deque<Segment> _segments;
+    std::size_t _head_written;
+    std::size_t _size;
+
+    // Reused between writes
+    std::vector<struct iovec> _iov;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_OUTPUT_BUFFER_H
@@ -0,0 +1,80 @@
+#include "ReadBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+
+// Large payload expected by caller is read at once up to this size, larger ones come by parts
+static const std::size_t max_expected = 1 << 20;
+
+// See ReadBuffer.h
+ReadBuffer::ReadBuffer(std::size_t capacity)
+    : _initial(capacity), _data(new char[capacity]), _capacity(capacity), _begin(0), _end(0) {}
+
+// See ReadBuffer.h
+void ReadBuffer::Consume(std::size_t n) {
+    assert(n <= Size());
+    _begin += n;
+    if (_begin == _end) {
+        _begin = _end = 0;
+    }
+}
+
+// See ReadBuffer.h
+ssize_t ReadBuffer::ReadFrom(int fd, std::size_t expected) {
+    Reserve(std::max<std::size_t>(std::min(expected, max_expected), 1));
+
+    ssize_t n = read(fd, _data.get() + _end, _capacity - _end);
+    if (n > 0) {
+        _end += n;
+    }
+    return n;
+}
+
+// See ReadBuffer.h
+void ReadBuffer::Clear() {
+    _begin = _end = 0;
+    if (_capacity > _initial) {
+        _data.reset(new char[_initial]);
+        _capacity = _initial;
+    }
+}
+
+void ReadBuffer::Reserve(std::size_t n) {
+    std::size_t size = Size();
+    if (size == 0 && _capacity > _initial && n <= _initial) {
+        // Large piece is gone, give memory back
+        _data.reset(new char[_initial]);
+        _capacity = _initial;
+        _begin = _end = 0;
+    }
+
+    // Small free tail isn't worth a read call, data is moved to the front then or buffer grows
+    std::size_t want = std::max(n, _initial / 4);
+    if (_capacity - _end >= want) {
+        return;
+    }
+
+    std::size_t capacity = _capacity;
+    while (capacity - size < want) {
+        capacity *= 2;
+    }
+    if (capacity == _capacity) {
+        std::memmove(_data.get(), Data(), size);
+    } else {
+        std::unique_ptr<char[]> data(new char[capacity]);
+        std::memcpy(data.get(), Data(), size);
+        _data = std::move(data);
+        _capacity = capacity;
+    }
+    _begin = 0;
+    _end = size;
+}
+
+} // namespace Network
+} // namespace Afina
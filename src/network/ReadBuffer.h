@@ -0,0 +1,64 @@
+#ifndef AFINA_NETWORK_READ_BUFFER_H
+#define AFINA_NETWORK_READ_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+
+#include <sys/types.h>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Connection input buffer
+ * Bytes read from the socket are consumed by advancing a cursor, so parsing pipelined commands doesn't move the
+ * rest of the input after each of them. Unconsumed tail is moved to the front at most once per read, and only if
+ * free space at the end got too small.
+ *
+ * Buffer grows when it is full of unconsumed data or when caller expects a large piece, e.g. body of a set, that
+ * could be read at once then. Memory above the initial capacity is released once buffer becomes empty.
+ */
+class ReadBuffer {
+public:
+    explicit ReadBuffer(std::size_t capacity = 4096);
+
+    // Unconsumed bytes
+    inline const char *Data() const { return _data.get() + _begin; }
+    inline std::size_t Size() const { return _end - _begin; }
+
+    /**
+     * Drops n bytes from the front of unconsumed data
+     */
+    void Consume(std::size_t n);
+
+    /**
+     * Reads as much as fits from the socket. At least expected bytes of free space is made first, so large
+     * payload known in advance comes in with a single call. Returns result of read(2)
+     */
+    ssize_t ReadFrom(int fd, std::size_t expected = 0);
+
+    /**
+     * Drops all the data
+     */
+    void Clear();
+
+private:
+    ReadBuffer(const ReadBuffer &) = delete;
+    ReadBuffer &operator=(const ReadBuffer &) = delete;
+
+    // Makes at least n bytes of space at the end
+    void Reserve(std::size_t n);
+
+    const std::size_t _initial;
+    std::unique_ptr<char[]> _data;
+    std::size_t _capacity;
+
+    // Unconsumed data is [_begin, _end)
+    std::size_t _begin;
+    std::size_t _end;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_READ_BUFFER_H
@@ -0,0 +1,162 @@
+#include "TimerWheel.h"
+
+#include <cassert>
+#include <chrono>
+#include <climits>
+
+namespace Afina {
+namespace Network {
+
+// See TimerWheel.h
+TimerWheel::TimerWheel(uint64_t now, uint64_t tick) : _tick(tick), _now(now / tick), _size(0) {
+    assert(tick > 0);
+    for (int level = 0; level < levels; level++) {
+        for (int i = 0; i < slots; i++) {
+            _slots[level][i]._prev = _slots[level][i]._next = &_slots[level][i];
+        }
+        _occupied[level] = 0;
+    }
+}
+
+// See TimerWheel.h
+void TimerWheel::Schedule(Timer &timer, uint64_t when) {
+    Cancel(timer);
+
+    // Never fire early, and the current slot is processed already
+    uint64_t expires = (when + _tick - 1) / _tick;
+    if (expires <= _now) {
+        expires = _now + 1;
+    }
+    timer._expires = expires;
+    timer._wheel = this;
+    _size++;
+    Insert(timer);
+}
+
+// See TimerWheel.h
+void TimerWheel::Cancel(Timer &timer) {
+    if (timer._wheel != this) {
+        return;
+    }
+
+    timer._prev->_next = timer._next;
+    timer._next->_prev = timer._prev;
+    Timer &head = _slots[timer._slot / slots][timer._slot % slots];
+    if (head._next == &head) {
+        _occupied[timer._slot / slots] &= ~(uint64_t(1) << (timer._slot % slots));
+    }
+
+    timer._prev = timer._next = nullptr;
+    timer._wheel = nullptr;
+    _size--;
+}
+
+// See TimerWheel.h
+void TimerWheel::Advance(uint64_t now, std::vector<Timer *> &expired) {
+    uint64_t target = now / _tick;
+    while (_now < target) {
+        if (_size == 0) {
+            _now = target;
+            break;
+        }
+
+        // Jump over empty slots
+        uint64_t next = NextTick();
+        if (next > target) {
+            _now = target;
+            break;
+        }
+        _now = next;
+
+        // Level is due once all the levels below have turned over, upper ones go first
+        int due = 1;
+        while (due < levels && (_now & ((uint64_t(1) << (slot_bits * due)) - 1)) == 0) {
+            due++;
+        }
+        for (int level = due - 1; level > 0; level--) {
+            Cascade(level);
+        }
+
+        Timer &head = _slots[0][_now & (slots - 1)];
+        while (head._next != &head) {
+            Timer *timer = head._next;
+            Cancel(*timer);
+            expired.push_back(timer);
+        }
+    }
+}
+
+// See TimerWheel.h
+int TimerWheel::Timeout(uint64_t now) const {
+    if (_size == 0) {
+        return -1;
+    }
+
+    uint64_t when = NextTick() * _tick;
+    if (when <= now) {
+        return 0;
+    }
+    return when - now > INT_MAX ? INT_MAX : int(when - now);
+}
+
+// See TimerWheel.h
+uint64_t TimerWheel::Now() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+uint64_t TimerWheel::NextTick() const {
+    // Either the first non empty slot of the bottom level or its turnover, when upper levels are due
+    uint64_t idx = _now & (slots - 1);
+    uint64_t turnover = _now - idx + slots;
+    uint64_t ahead = (idx == slots - 1) ? 0 : _occupied[0] & (~uint64_t(0) << (idx + 1));
+    if (ahead != 0) {
+        return _now - idx + __builtin_ctzll(ahead);
+    }
+    return turnover;
+}
+
+void TimerWheel::Insert(Timer &timer) {
+    // Farthest timers wait on the last slot of the top level
+    uint64_t span = uint64_t(1) << (slot_bits * levels);
+    if (timer._expires - _now >= span) {
+        timer._expires = _now + span - 1;
+    }
+
+    int level = 0;
+    while ((timer._expires - _now) >> (slot_bits * (level + 1)) != 0) {
+        level++;
+    }
+    int idx = (timer._expires >> (slot_bits * level)) & (slots - 1);
+
+    Timer &head = _slots[level][idx];
+    timer._prev = head._prev;
+    timer._next = &head;
+    head._prev->_next = &timer;
+    head._prev = &timer;
+    timer._slot = level * slots + idx;
+    _occupied[level] |= uint64_t(1) << idx;
+}
+
+void TimerWheel::Cascade(int level) {
+    int idx = (_now >> (slot_bits * level)) & (slots - 1);
+    Timer &head = _slots[level][idx];
+    if (head._next == &head) {
+        return;
+    }
+
+    // Detach the whole slot first, then spread timers over the levels below
+    Timer *first = head._next;
+    head._prev->_next = nullptr;
+    head._prev = head._next = &head;
+    _occupied[level] &= ~(uint64_t(1) << idx);
+
+    for (Timer *timer = first; timer != nullptr;) {
+        Timer *next = timer->_next;
+        Insert(*timer);
+        timer = next;
+    }
+}
+
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,118 @@
+#ifndef AFINA_NETWORK_TIMER_WHEEL_H
+#define AFINA_NETWORK_TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Hierarchical timer wheel
+ * Timers of an event loop, e.g. idle timeouts of its connections. Time is counted in ticks of fixed length, each
+ * level of the wheel has 64 slots and every slot of a level spans 64 slots of the level below. Timer is put to the
+ * lowest level which range covers it and moves down as the time comes, so scheduling and cancelling are O(1) and
+ * no work is done for timers that are far away.
+ *
+ * Timers are intrusive, owner embeds them and wheel never allocates. Wheel is not thread safe.
+ */
+class TimerWheel {
+public:
+    class Timer {
+    public:
+        Timer() : _prev(nullptr), _next(nullptr), _wheel(nullptr), _expires(0), _slot(0), data(nullptr) {}
+        ~Timer() {
+            if (_wheel != nullptr) {
+                _wheel->Cancel(*this);
+            }
+        }
+
+        inline bool Armed() const { return _wheel != nullptr; }
+
+    private:
+        friend class TimerWheel;
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+        Timer *_prev;
+        Timer *_next;
+
+        // Wheel timer is armed in
+        TimerWheel *_wheel;
+
+        // Tick to fire on and index of the slot it is linked to
+        uint64_t _expires;
+        int _slot;
+
+    public:
+        // Anything owner wants to get back with expired timer
+        void *data;
+    };
+
+    /**
+     * Creates wheel counting time from now in ticks of the given number of milliseconds
+     */
+    TimerWheel(uint64_t now, uint64_t tick);
+
+    /**
+     * Arms timer to fire at the given time, timer that is armed already is moved
+     */
+    void Schedule(Timer &timer, uint64_t when);
+
+    /**
+     * Disarms timer, does nothing if it isn't armed
+     */
+    void Cancel(Timer &timer);
+
+    /**
+     * Moves wheel to the given time, timers that are due are disarmed and appended to expired
+     */
+    void Advance(uint64_t now, std::vector<Timer *> &expired);
+
+    /**
+     * Milliseconds until the wheel has to be advanced next time, suitable for epoll_wait. -1 if there are no
+     * timers. Wakeup may fire no timer when it is needed to move ones from upper levels down
+     */
+    int Timeout(uint64_t now) const;
+
+    inline std::size_t Size() const { return _size; }
+
+    /**
+     * Milliseconds of monotonic clock
+     */
+    static uint64_t Now();
+
+private:
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    static const int levels = 4;
+    static const int slot_bits = 6;
+    static const int slots = 1 << slot_bits;
+
+    // Nearest tick when something is to be done
+    uint64_t NextTick() const;
+
+    // Links timer to the slot its expiration falls into
+    void Insert(Timer &timer);
+
+    // Moves timers of the slot of the given level one level down
+    void Cascade(int level);
+
+    const uint64_t _tick;
+
+    // Ticks passed since epoch of the clock, all the slots up to it are processed
+    uint64_t _now;
+    std::size_t _size;
+
+    // Slots are circular lists with sentinel heads, bit is set for non empty slot
+    Timer _slots[levels][slots];
+    uint64_t _occupied[levels];
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_TIMER_WHEEL_H
@@ -0,0 +1,72 @@
+#include "Utils.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+namespace Afina {
+namespace Network {
+
+// See Utils.h
+int Listen(uint16_t port, bool reuseport) {
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    int server_socket = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+    if (server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    // Server closes idle connections itself, their TIME_WAIT must not prevent restart
+    if (setsockopt(server_socket, SOL_SOCKET, SO_KEEPALIVE, &opts, sizeof(opts)) == -1 ||
+        setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        (reuseport && setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1)) {
+        close(server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(server_socket, SOMAXCONN) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+    return server_socket;
+}
+
+// See Utils.h
+int ListenOrInherit(std::vector<int> &inherited, uint16_t port, bool reuseport) {
+    if (inherited.empty()) {
+        return Listen(port, reuseport);
+    }
+    int server_socket = inherited.back();
+    inherited.pop_back();
+    return server_socket;
+}
+
+// See Utils.h
+void DropInherited(std::vector<int> &inherited, spdlog::logger &logger) {
+    for (int socket : inherited) {
+        logger.warn("Close extra inherited socket {}", socket);
+        close(socket);
+    }
+    inherited.clear();
+}
+
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,34 @@
+#ifndef AFINA_NETWORK_UTILS_H
+#define AFINA_NETWORK_UTILS_H
+
+#include <cstdint>
+#include <vector>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+
+/**
+ * Creates non blocking socket listening on the given port of any address, throws std::runtime_error on failure.
+ * With reuseport set several sockets may listen on the same port, kernel spreads connections between them
+ */
+int Listen(uint16_t port, bool reuseport);
+
+/**
+ * Takes one of sockets inherited from the previous process and removes it from the vector, or calls Listen if
+ * there are none left. Previous process keeps accepting on the same socket until it stops
+ */
+int ListenOrInherit(std::vector<int> &inherited, uint16_t port, bool reuseport);
+
+/**
+ * Closes inherited sockets server has no use for, previous process might have had more of them
+ */
+void DropInherited(std::vector<int> &inherited, spdlog::logger &logger);
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_UTILS_H
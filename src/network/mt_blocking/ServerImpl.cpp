@@ -22,6 +22,7 @@
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 
+#include "network/ReadBuffer.h"
 #include "protocol/Parser.h"
 
 namespace Afina {
@@ -29,7 +30,9 @@ namespace Network {
 namespace MTblocking {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+                       uint32_t low_watermark, uint32_t high_watermark, uint32_t max_queue_size, uint32_t idle_time)
+    : Server(ps, pl), _executor("network", low_watermark, high_watermark, max_queue_size, idle_time) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -39,8 +42,6 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
     _logger = pLogging->select("network");
     _logger->info("Start mt_blocking network service");
 
-    _worker_num = n_workers;
-    _worker_current = 0;
     sigset_t sig_mask;
     sigemptyset(&sig_mask);
     sigaddset(&sig_mask, SIGPIPE);
@@ -76,6 +77,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
     }
 
     running.store(true);
+    _executor.Start();
     _thread = std::thread(&ServerImpl::OnRun, this);
 }
 
@@ -95,6 +97,7 @@ void ServerImpl::Stop() {
 void ServerImpl::Join() {
     assert(_thread.joinable());
     _thread.join();
+    _executor.Stop(true);
     close(_server_socket);
 }
 
@@ -141,18 +144,16 @@ void ServerImpl::OnRun() {
             setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
         }
 
-        // TODO: Start new thread and process data from/to connection
+        // Connection waits in the pool queue until some thread is free, it is refused only when queue is full
         {
             // чтобы записать в  список
             std::lock_guard<std::mutex> lock(_worker_mutex);
-            if (_worker_sockets.size() == _worker_num) {
-                std::string msg = "Achieved max number of theads!";
+            _worker_sockets.push_front(client_socket);
+            if (!_executor.Execute(&ServerImpl::_worker_onrun, this, client_socket, _worker_sockets.begin())) {
+                _worker_sockets.pop_front();
+                std::string msg = "SERVER_ERROR Server is overloaded\r\n";
                 send(client_socket, msg.data(), msg.size(), 0);
                 close(client_socket);
-            } else {
-                _worker_sockets.push_front(client_socket);
-                std::thread _work(&ServerImpl::_worker_onrun, this, client_socket, _worker_sockets.begin());
-                _work.detach();
             }
         }
     }
@@ -167,27 +168,27 @@ void ServerImpl::OnRun() {
 }
 
 void ServerImpl::_worker_onrun(int client_socket, std::list<int>::iterator it_socket) {
-    std::size_t arg_remains;
+    std::size_t arg_remains = 0;
     Protocol::Parser parser;
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
 
     try {
         int readed_bytes = -1;
-        char client_buffer[4096];
-        while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
+        ReadBuffer client_buffer;
+        while ((readed_bytes = client_buffer.ReadFrom(client_socket, arg_remains)) > 0) {
             _logger->debug("Got {} bytes from socket", readed_bytes);
 
             // Single block of data readed from the socket could trigger inside actions a multiple times,
             // for example:
             // - read#0: [<command1 start>]
             // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-            while (readed_bytes > 0) {
-                _logger->debug("Process {} bytes", readed_bytes);
+            while (client_buffer.Size() > 0) {
+                _logger->debug("Process {} bytes", client_buffer.Size());
                 // There is no command yet
                 if (!command_to_execute) {
                     std::size_t parsed = 0;
-                    if (parser.Parse(client_buffer, readed_bytes, parsed)) {
+                    if (parser.Parse(client_buffer.Data(), client_buffer.Size(), parsed)) {
                         // There is no command to be launched, continue to parse input stream
                         // Here we are, current chunk finished some command, process it
                         _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
@@ -202,21 +203,19 @@ void ServerImpl::_worker_onrun(int client_socket, std::list<int>::iterator it_so
                     if (parsed == 0) {
                         break;
                     } else {
-                        std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                        readed_bytes -= parsed;
+                        client_buffer.Consume(parsed);
                     }
                 }
 
                 // There is command, but we still wait for argument to arrive...
                 if (command_to_execute && arg_remains > 0) {
-                    _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
+                    _logger->debug("Fill argument: {} bytes of {}", client_buffer.Size(), arg_remains);
                     // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                    argument_for_command.append(client_buffer, to_read);
+                    std::size_t to_read = std::min(arg_remains, client_buffer.Size());
+                    argument_for_command.append(client_buffer.Data(), to_read);
 
-                    std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
+                    client_buffer.Consume(to_read);
                     arg_remains -= to_read;
-                    readed_bytes -= to_read;
                 }
 
                 // Thre is command & argument - RUN!
@@ -237,7 +236,7 @@ void ServerImpl::_worker_onrun(int client_socket, std::list<int>::iterator it_so
                     argument_for_command.resize(0);
                     parser.Reset();
                 }
-            } // while (readed_bytes)
+            } // while (client_buffer)
         }
 
         if (readed_bytes == 0) {
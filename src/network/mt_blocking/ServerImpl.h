@@ -7,6 +7,7 @@
 #include <mutex>
 #include <thread>
 
+#include <afina/concurrency/Executor.h>
 #include <afina/network/Server.h>
 
 namespace spdlog {
@@ -19,11 +20,14 @@ namespace MTblocking {
 
 /**
 * # Network resource manager implementation
-* Server that is spawning a separate thread for each connection
+* Server that is serving each connection by a thread of the pool. Pool keeps low_watermark threads ready and grows
+* up to high_watermark ones, connections that find no free thread wait in the queue of max_queue_size. Only once
+* queue is full new connections are refused
 */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, uint32_t low_watermark = 2,
+               uint32_t high_watermark = 16, uint32_t max_queue_size = 64, uint32_t idle_time = 10000);
     ~ServerImpl();
 
     // See Server.h
@@ -57,7 +61,9 @@ private:
     // Thread to run network on
     std::thread _thread;
 
-    int _worker_num, _worker_current;
+    // Threads serving connections
+    Concurrency::Executor _executor;
+
     std::mutex _worker_mutex;
     std::condition_variable _worker_cv;
     // Doing all work for one thread
@@ -0,0 +1,98 @@
+#include "Balancer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "Connection.h"
+#include "Registry.h"
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+// See Balancer.h
+Balancer::Balancer(std::vector<std::shared_ptr<Registry>> registries)
+    : _slots(new Slot[registries.size()]), _size(registries.size()) {
+    for (std::size_t i = 0; i < _size; i++) {
+        _slots[i].registry = std::move(registries[i]);
+        _slots[i].mailbox.store(nullptr, std::memory_order_relaxed);
+        _slots[i].load.store(0, std::memory_order_relaxed);
+        _slots[i].event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_slots[i].event_fd == -1) {
+            for (std::size_t j = 0; j < i; j++) {
+                close(_slots[j].event_fd);
+            }
+            throw std::runtime_error("Failed to create mailbox eventfd: " + std::string(strerror(errno)));
+        }
+    }
+}
+
+// See Balancer.h
+Balancer::~Balancer() {
+    for (std::size_t i = 0; i < _size; i++) {
+        close(_slots[i].event_fd);
+    }
+}
+
+// See Balancer.h
+int Balancer::Fd(std::size_t worker) const { return _slots[worker].event_fd; }
+
+// See Balancer.h
+void Balancer::Report(std::size_t worker, uint32_t load) {
+    _slots[worker].load.store(load, std::memory_order_relaxed);
+}
+
+// See Balancer.h
+int Balancer::Idle(std::size_t worker) const {
+    // Start right after the caller, so busy workers don't pick the same one
+    for (std::size_t i = 1; i < _size; i++) {
+        std::size_t peer = (worker + i) % _size;
+        if (_slots[peer].load.load(std::memory_order_relaxed) == 0) {
+            return peer;
+        }
+    }
+    return -1;
+}
+
+// See Balancer.h
+void Balancer::Migrate(std::size_t from, std::size_t to, Connection *pc) {
+    _slots[from].registry->Remove(pc);
+    _slots[to].registry->Add(pc);
+
+    // Treiber push, the owner takes the whole stack so there is no ABA
+    Slot &slot = _slots[to];
+    Connection *head = slot.mailbox.load(std::memory_order_relaxed);
+    do {
+        pc->_mail_next = head;
+    } while (!slot.mailbox.compare_exchange_weak(head, pc, std::memory_order_release, std::memory_order_relaxed));
+
+    // Owner reads eventfd before it takes the stack, so wakeup is needed only for the first connection
+    if (head == nullptr) {
+        eventfd_write(slot.event_fd, 1);
+    }
+}
+
+// See Balancer.h
+void Balancer::Take(std::size_t worker, std::vector<Connection *> &result) {
+    Slot &slot = _slots[worker];
+    eventfd_t value;
+    eventfd_read(slot.event_fd, &value);
+
+    std::size_t first = result.size();
+    for (Connection *pc = slot.mailbox.exchange(nullptr, std::memory_order_acquire); pc != nullptr;
+         pc = pc->_mail_next) {
+        result.push_back(pc);
+    }
+
+    // Stack is LIFO, serve connections in the order they came
+    std::reverse(result.begin() + first, result.end());
+}
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
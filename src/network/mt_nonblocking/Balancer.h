@@ -0,0 +1,82 @@
+#ifndef AFINA_NETWORK_MT_NONBLOCKING_BALANCER_H
+#define AFINA_NETWORK_MT_NONBLOCKING_BALANCER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+// Forward declaration, see Registry.h
+class Registry;
+
+/**
+ * # Connections rebalancing between private workers
+ * With reuseport every worker owns its connections until they are closed, so a few hot clients accepted by the
+ * same worker keep a single core busy while others sleep. Worker publishes its run queue length, that is number of
+ * connections ready on the last wakeup and 0 while it waits in epoll_wait. Busy worker that sees an idle one gives
+ * it a connection: removes it from own epoll and posts to the mailbox of the idle worker.
+ *
+ * Mailbox is a lock-free stack, any worker pushes and the owner takes all at once. Owner watches eventfd of the
+ * mailbox in its epoll, it is signalled when the stack stops being empty. Connection moves to the registry of the
+ * new owner before it is posted, so server finds it on stop even if it is still in the mailbox.
+ */
+class Balancer {
+public:
+    explicit Balancer(std::vector<std::shared_ptr<Registry>> registries);
+    ~Balancer();
+
+    /**
+     * Eventfd of the worker mailbox, readable once something is posted there
+     */
+    int Fd(std::size_t worker) const;
+
+    /**
+     * Publishes number of connections worker is going to serve right now
+     */
+    void Report(std::size_t worker, uint32_t load);
+
+    /**
+     * Worker with nothing to do other than the given one, or -1 if everyone is busy
+     */
+    int Idle(std::size_t worker) const;
+
+    /**
+     * Passes connection to another worker. Caller must have removed connection from its epoll already and must not
+     * touch it afterwards
+     */
+    void Migrate(std::size_t from, std::size_t to, Connection *pc);
+
+    /**
+     * Appends connections posted to the worker to the given list, worker registers them in its epoll
+     */
+    void Take(std::size_t worker, std::vector<Connection *> &result);
+
+private:
+    Balancer(const Balancer &) = delete;
+    Balancer &operator=(const Balancer &) = delete;
+
+    struct Slot {
+        std::shared_ptr<Registry> registry;
+        int event_fd;
+        std::atomic<Connection *> mailbox;
+        std::atomic<uint32_t> load;
+    };
+
+    // Slots are never moved, atomics live there
+    std::unique_ptr<Slot[]> _slots;
+    const std::size_t _size;
+};
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_NONBLOCKING_BALANCER_H
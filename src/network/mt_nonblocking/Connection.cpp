@@ -13,6 +13,7 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <spdlog/logger.h>
@@ -34,10 +35,9 @@ void Connection::Start() {
     command_to_execute.reset();
     argument_for_command.resize(0);
     parser.Reset();
-    results_to_write.clear();
+    _output.Clear();
     arg_remains = 0;
-    _written_bytes = 0;
-    _readed_bytes = 0;
+    _buffer.Clear();
     _event.events = Masks::read;
 }
 
@@ -57,20 +57,19 @@ void Connection::OnClose() {
 void Connection::DoRead() {
     std::unique_lock<std::mutex> lock(_lock);
     int client_socket = _socket;
-    command_to_execute = nullptr;
     try {
-        while ((new_bytes = read(client_socket, client_buffer + _readed_bytes, sizeof(client_buffer) - _readed_bytes)) >
-               0) {
-            _readed_bytes += new_bytes;
+        // Command could be parsed out by the previous call already, its argument is read at once then
+        ssize_t new_bytes;
+        while ((new_bytes = _buffer.ReadFrom(client_socket, arg_remains)) > 0) {
             // Single block of data read from the socket could trigger inside actions a multiple times,
             // for example:
             // - read#0: [<command1 start>]
             // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-            while (_readed_bytes > 0) {
+            while (_buffer.Size() > 0) {
                 // There is no command yet
                 if (!command_to_execute) {
                     std::size_t parsed = 0;
-                    if (parser.Parse(client_buffer, _readed_bytes, parsed)) {
+                    if (parser.Parse(_buffer.Data(), _buffer.Size(), parsed)) {
                         // There is no command to be launched, continue to parse input stream
                         // Here we are, current chunk finished some command, process it
                         command_to_execute = parser.Build(arg_remains);
@@ -84,29 +83,26 @@ void Connection::DoRead() {
                     if (parsed == 0) {
                         break;
                     } else {
-                        std::memmove(client_buffer, client_buffer + parsed, _readed_bytes - parsed);
-                        _readed_bytes -= parsed;
+                        _buffer.Consume(parsed);
                     }
                 }
 
                 // There is command, but we still wait for argument to arrive...
                 if (command_to_execute && arg_remains > 0) {
                     // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(_readed_bytes));
-                    argument_for_command.append(client_buffer, to_read);
+                    std::size_t to_read = std::min(arg_remains, _buffer.Size());
+                    argument_for_command.append(_buffer.Data(), to_read);
 
-                    std::memmove(client_buffer, client_buffer + to_read, _readed_bytes - to_read);
+                    _buffer.Consume(to_read);
                     arg_remains -= to_read;
-                    _readed_bytes -= to_read;
                 }
 
                 // There is command & argument - RUN!
                 if (command_to_execute && arg_remains == 0) {
-                    std::string result_to_write;
-                    command_to_execute->Execute(*pStorage, argument_for_command, result_to_write);
-                    result_to_write += "\r\n";
-                    // Save results for better time
-                    results_to_write.push_back(result_to_write);
+                    // Responses of the whole burst are gathered and written once it is parsed. Large values are not
+                    // copied, output refers to storage buffers
+                    command_to_execute->Execute(*pStorage, argument_for_command, _output);
+                    _output.Append("\r\n", 2);
 
                     // Prepare for the next command
                     command_to_execute.reset();
@@ -117,7 +113,7 @@ void Connection::DoRead() {
                 }
             } // while (read_bytes)
         }
-        if (_readed_bytes > 0) {
+        if (_buffer.Size() > 0) {
             throw std::runtime_error(std::string(strerror(errno)));
         }
     } catch (std::runtime_error &ex) {
@@ -127,31 +123,22 @@ void Connection::DoRead() {
 // See Connection.h
 void Connection::DoWrite() {
     std::unique_lock<std::mutex> lock(_lock);
-    static int max_iov = 128;
-    int results_num = results_to_write.size();
-    // assert(results_num > 0);
-
-    auto results_it = results_to_write.begin();
-    struct iovec results_iov[max_iov];
-
-    for (int i = 0; i < max_iov && i < results_num; ++i, ++results_it) {
-        results_iov[i].iov_base = &(*results_it)[0];
-        results_iov[i].iov_len = (*results_it).size();
+    if (_output.Empty()) {
+        _event.events = Masks::read;
+        return;
     }
-    results_iov[0].iov_base = results_iov[0].iov_base + _written_bytes;
-    results_iov[0].iov_len -= _written_bytes;
 
-    int written = writev(_socket, results_iov, results_num);
-    _written_bytes += written;
-
-    auto end_it = results_to_write.begin();
-    for (auto it = &results_iov[0]; _written_bytes > (*it).iov_len; ++it, ++end_it) {
-        _written_bytes -= (*it).iov_len;
+    if (_output.WriteTo(_socket) < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            state = State::Dead;
+        }
+        return;
     }
 
-    results_to_write.erase(results_to_write.begin(), end_it);
-    if (results_to_write.size() == 0) {
+    if (_output.Empty()) {
         _event.events = Masks::read;
+    } else {
+        _event.events = Masks::read_write;
     }
 }
 
@@ -1,6 +1,7 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <mutex>
@@ -9,6 +10,10 @@
 #include <afina/execute/Command.h>
 #include <protocol/Parser.h>
 
+#include <network/OutputBuffer.h>
+#include <network/ReadBuffer.h>
+#include <network/TimerWheel.h>
+
 #include <sys/epoll.h>
 
 namespace Afina {
@@ -20,6 +25,9 @@ public:
     Connection(int s, std::shared_ptr<Afina::Storage> ps) : _socket(s), pStorage(ps) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
+        _timer.data = this;
+        _mail_next = nullptr;
+        _migrated = 0;
     }
 
     enum class State { Alive, Dead };
@@ -37,6 +45,11 @@ public:
         return false;
     }
 
+    // No command is half read and no response is unwritten, so connection could be passed to another process as is
+    inline bool isIdle() const {
+        return _output.Empty() && _buffer.Size() == 0 && !command_to_execute && parser.Clean();
+    }
+
     void Start();
 
 protected:
@@ -48,6 +61,8 @@ protected:
 private:
     friend class Worker;
     friend class ServerImpl;
+    friend class Registry;
+    friend class Balancer;
 
     int _socket;
     struct epoll_event _event;
@@ -62,12 +77,18 @@ private:
     std::shared_ptr<Afina::Storage> pStorage;
 
     // save state of reading
-    int _written_bytes;
-    int _readed_bytes;
-    int new_bytes;
-    char client_buffer[4096];
+    ReadBuffer _buffer;
+
+    // Responses waiting to be written, all of them go out with one call
+    OutputBuffer _output;
+
+    // Idle timeout, see Registry
+    TimerWheel::Timer _timer;
+    std::atomic<uint64_t> _last_activity;
 
-    std::vector<std::string> results_to_write;
+    // Link in the mailbox of the worker connection moves to and when it moved last time, see Balancer
+    Connection *_mail_next;
+    uint64_t _migrated;
 };
 
 } // namespace MTnonblock
@@ -0,0 +1,70 @@
+#include "Registry.h"
+
+#include <algorithm>
+
+#include <sys/socket.h>
+
+#include "Connection.h"
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+// See Registry.h
+Registry::Registry(uint32_t idle_timeout)
+    : _idle_timeout(idle_timeout), _wheel(TimerWheel::Now(), std::max<uint64_t>(idle_timeout / 64, 1)) {}
+
+// See Registry.h
+void Registry::Add(Connection *pc) {
+    uint64_t now = TimerWheel::Now();
+    pc->_last_activity.store(now, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _connections.insert(pc);
+    if (_idle_timeout > 0) {
+        _wheel.Schedule(pc->_timer, now + _idle_timeout);
+    }
+}
+
+// See Registry.h
+void Registry::Remove(Connection *pc) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _connections.erase(pc);
+    _wheel.Cancel(pc->_timer);
+}
+
+// See Registry.h
+int Registry::Expire(uint64_t now) {
+    if (_idle_timeout == 0) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _expired.clear();
+    _wheel.Advance(now, _expired);
+    for (auto timer : _expired) {
+        Connection *pc = static_cast<Connection *>(timer->data);
+        uint64_t last = pc->_last_activity.load(std::memory_order_relaxed);
+        if (last + _idle_timeout > now) {
+            _wheel.Schedule(*timer, last + _idle_timeout);
+        } else {
+            shutdown(pc->_socket, SHUT_RDWR);
+        }
+    }
+    return _wheel.Timeout(TimerWheel::Now());
+}
+
+// See Registry.h
+std::vector<Connection *> Registry::Take() {
+    std::lock_guard<std::mutex> lock(_lock);
+    std::vector<Connection *> result(_connections.begin(), _connections.end());
+    for (auto pc : result) {
+        _wheel.Cancel(pc->_timer);
+    }
+    _connections.clear();
+    return result;
+}
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
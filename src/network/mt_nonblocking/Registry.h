@@ -0,0 +1,66 @@
+#ifndef AFINA_NETWORK_MT_NONBLOCKING_REGISTRY_H
+#define AFINA_NETWORK_MT_NONBLOCKING_REGISTRY_H
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include <network/TimerWheel.h>
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+/**
+ * # Connections served by workers
+ * Keeps track of live connections, so that server could drain them on stop, and closes ones that stay idle for too
+ * long. Registry is guarded by lock, because connections of the shared epoll move between workers. With reuseport
+ * every worker has its own instance and lock is never contended.
+ *
+ * Activity is recorded in connection without the lock, timer that fires for connection active since then is moved
+ * forward. Idle connection is shut down rather than closed: worker that gets the hangup deletes it as usual, so
+ * connection never disappears under the feet of worker serving it.
+ */
+class Registry {
+public:
+    // Idle timeout in milliseconds, 0 disables it
+    explicit Registry(uint32_t idle_timeout);
+
+    /**
+     * Starts to watch for the new connection, must be called before it could get any event
+     */
+    void Add(Connection *pc);
+
+    /**
+     * Stops to watch for the connection, must be called before its socket is closed
+     */
+    void Remove(Connection *pc);
+
+    /**
+     * Shuts down connections that are idle for too long, returns epoll_wait timeout
+     */
+    int Expire(uint64_t now);
+
+    /**
+     * Hands all the connections over to the caller and forgets them. Workers must be stopped by then
+     */
+    std::vector<Connection *> Take();
+
+private:
+    const uint32_t _idle_timeout;
+
+    std::mutex _lock;
+    std::unordered_set<Connection *> _connections;
+    TimerWheel _wheel;
+    std::vector<TimerWheel::Timer *> _expired;
+};
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_NONBLOCKING_REGISTRY_H
@@ -1,10 +1,12 @@
 #include "ServerImpl.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <unordered_set>
 
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -21,7 +23,12 @@
 #include <afina/Storage.h>
 #include <afina/logging/Service.h>
 
+#include <network/Handoff.h>
+#include <network/Utils.h>
+
+#include "Balancer.h"
 #include "Connection.h"
+#include "Registry.h"
 #include "Utils.h"
 #include "Worker.h"
 
@@ -30,7 +37,10 @@ namespace Network {
 namespace MTnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, bool reuseport,
+                       uint32_t idle_timeout, uint32_t drain_timeout)
+    : Server(ps, pl), _reuseport(reuseport), _idle_timeout(idle_timeout), _drain_timeout(drain_timeout),
+      _server_socket(-1), _data_epoll_fd(-1), _event_fd(-1), _adopted(0) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -47,56 +57,63 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Unable to mask SIGPIPE");
     }
 
-    // Create server socket
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;         // IPv4
-    server_addr.sin_port = htons(port);       // TCP port number
-    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
-
-    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (_server_socket == -1) {
-        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    int opts = 1;
-    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
-    }
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
 
-    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
-    }
+    if (_reuseport) {
+        // Each worker gets private socket and epoll, eventfd is shared to wake them all at once
+        _workers.reserve(n_workers);
+        for (int i = 0; i < n_workers; i++) {
+            int epoll_fd = epoll_create1(0);
+            if (epoll_fd == -1) {
+                throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+            }
+            _worker_epoll_fds.push_back(epoll_fd);
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+                throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+            }
 
-    make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+            _worker_sockets.push_back(ListenOrInherit(inheritedSockets, port, true));
+            _registries.push_back(std::make_shared<Registry>(_idle_timeout));
+        }
+        DropInherited(inheritedSockets, *_logger);
+
+        // Hot connections accepted by the same worker are spread to idle ones
+        std::shared_ptr<Balancer> balancer;
+        if (n_workers > 1) {
+            balancer = std::make_shared<Balancer>(_registries);
+        }
+        for (int i = 0; i < n_workers; i++) {
+            _workers.emplace_back(pStorage, pLogging, _registries[i], balancer, i);
+            _workers.back().Start(_worker_epoll_fds[i], _worker_sockets[i]);
+        }
+        return;
     }
 
+    _server_socket = ListenOrInherit(inheritedSockets, port, false);
+    DropInherited(inheritedSockets, *_logger);
+
     // Start IO workers
     _data_epoll_fd = epoll_create1(0);
     if (_data_epoll_fd == -1) {
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    _event_fd = eventfd(0, EFD_NONBLOCK);
-    if (_event_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
-
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.ptr = nullptr;
     if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
         throw std::runtime_error("Failed to add eventfd descriptor to epoll");
     }
 
+    // Connection could be served by any worker, so they share registry as well
+    _registries.push_back(std::make_shared<Registry>(_idle_timeout));
     _workers.reserve(n_workers);
     for (int i = 0; i < n_workers; i++) {
-        _workers.emplace_back(pStorage, pLogging);
+        _workers.emplace_back(pStorage, pLogging, _registries.back());
         _workers.back().Start(_data_epoll_fd);
     }
 
@@ -115,12 +132,18 @@ void ServerImpl::Stop() {
         w.Stop();
     }
 
-    // Wakeup threads that are sleep on epoll_wait
+    // Wakeup threads that are sleep on epoll_wait. Nobody reads eventfd, so it stays readable and every thread
+    // gets it, even ones that share epoll
     if (eventfd_write(_event_fd, 1)) {
         throw std::runtime_error("Failed to wakeup workers");
     }
 
-    close(_server_socket);
+    if (_server_socket != -1) {
+        close(_server_socket);
+    }
+    for (int socket : _worker_sockets) {
+        close(socket);
+    }
 }
 
 // See Server.h
@@ -132,6 +155,142 @@ void ServerImpl::Join() {
     for (auto &w : _workers) {
         w.Join();
     }
+
+    for (int epoll_fd : _worker_epoll_fds) {
+        close(epoll_fd);
+    }
+    if (_data_epoll_fd != -1) {
+        close(_data_epoll_fd);
+    }
+
+    // Nobody serves connections anymore
+    Drain();
+    close(_event_fd);
+}
+
+// See ServerImpl.h
+void ServerImpl::Drain() {
+    uint64_t deadline = TimerWheel::Now() + _drain_timeout;
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    // No more commands are read, connections wait only for their responses to be written
+    std::size_t total = 0;
+    std::unordered_set<Connection *> pending;
+    std::vector<Connection *> done;
+    for (auto &registry : _registries) {
+        for (Connection *pc : registry->Take()) {
+            total++;
+            if (pc->isAlive() && !pc->_output.Empty()) {
+                pc->DoWrite();
+            }
+            if (pc->isAlive() && !pc->_output.Empty()) {
+                pc->_event.events = EPOLLOUT;
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event) == 0) {
+                    pending.insert(pc);
+                    continue;
+                }
+            }
+            done.push_back(pc);
+        }
+    }
+    _logger->warn("Drain {} connections, {} have responses to write", total, pending.size());
+
+    std::array<struct epoll_event, 64> mod_list;
+    for (uint64_t now = TimerWheel::Now(); !pending.empty() && now < deadline; now = TimerWheel::Now()) {
+        int nmod = epoll_wait(epoll_fd, &mod_list[0], mod_list.size(), deadline - now);
+        for (int i = 0; i < nmod; i++) {
+            Connection *pc = static_cast<Connection *>(mod_list[i].data.ptr);
+            pc->DoWrite();
+            if (pc->isAlive() && !pc->_output.Empty() && !(mod_list[i].events & (EPOLLERR | EPOLLHUP))) {
+                continue;
+            }
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pc->_socket, &pc->_event);
+            pending.erase(pc);
+            done.push_back(pc);
+        }
+    }
+    close(epoll_fd);
+
+    // Deadline has passed, the rest is dropped
+    if (!pending.empty()) {
+        _logger->error("Drop {} connections with unwritten responses", pending.size());
+    }
+    done.insert(done.end(), pending.begin(), pending.end());
+    HandOver(done);
+}
+
+// See ServerImpl.h
+void ServerImpl::HandOver(std::vector<Connection *> &connections) {
+    std::vector<int> idle;
+    for (Connection *pc : connections) {
+        if (handoffSocket != -1 && pc->isAlive() && pc->isIdle()) {
+            idle.push_back(pc->_socket);
+        }
+    }
+
+    // New process got its own descriptors, these are closed either way
+    std::size_t handed = 0;
+    try {
+        for (std::size_t i = 0; i < idle.size(); i += max_handoff) {
+            std::size_t n = std::min<std::size_t>(max_handoff, idle.size() - i);
+            SendDescriptors(handoffSocket, std::vector<int>(idle.begin() + i, idle.begin() + i + n));
+            handed += n;
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to hand connections over: {}", ex.what());
+    }
+    if (handed > 0) {
+        _logger->warn("Hand {} idle connections over to the new process", handed);
+    }
+
+    for (Connection *pc : connections) {
+        close(pc->_socket);
+        delete pc;
+    }
+    connections.clear();
+}
+
+// See Server.h
+std::vector<int> ServerImpl::Sockets() const {
+    if (_reuseport) {
+        return _worker_sockets;
+    }
+    return std::vector<int>{_server_socket};
+}
+
+// See Server.h
+Adoption ServerImpl::Adopt(int socket) {
+    make_socket_non_blocking(socket);
+    Connection *pc = new Connection(socket, pStorage);
+    pc->Start();
+    if (!pc->isAlive()) {
+        close(pc->_socket);
+        delete pc;
+        return Adoption::Dropped;
+    }
+
+    // Registered the same way acceptor or worker does for own connection
+    int epoll_fd = _data_epoll_fd;
+    auto &registry = _registries[_reuseport ? _adopted % _registries.size() : 0];
+    if (_reuseport) {
+        epoll_fd = _worker_epoll_fds[_adopted % _worker_epoll_fds.size()];
+    } else {
+        pc->_event.events |= EPOLLONESHOT;
+    }
+    _adopted++;
+
+    registry->Add(pc);
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+        _logger->error("Failed to add adopted connection to epoll: {}", strerror(errno));
+        registry->Remove(pc);
+        close(pc->_socket);
+        delete pc;
+        return Adoption::Dropped;
+    }
+    return Adoption::Adopted;
 }
 
 // See ServerImpl.h
@@ -204,7 +363,9 @@ void ServerImpl::OnRun() {
                 pc->Start();
                 if (pc->isAlive()) {
                     pc->_event.events |= EPOLLONESHOT;
+                    _registries.front()->Add(pc);
                     if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+                        _registries.front()->Remove(pc);
                         close(pc->_socket);
                         pc->OnError();
 
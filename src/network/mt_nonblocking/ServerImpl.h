@@ -1,7 +1,6 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 
-#include <set>
 #include <thread>
 #include <vector>
 
@@ -18,14 +17,28 @@ namespace MTnonblock {
 
 // Forward declaration, see Worker.h
 class Worker;
+class Registry;
 
 /**
  * # Network resource manager implementation
  * Epoll based server
+ *
+ * By default acceptors share one listening socket and hand connections over to epoll shared between workers, a
+ * connection is rearmed with EPOLLONESHOT after each event so that only one worker serves it at a time.
+ *
+ * With reuseport every worker has its own epoll and its own listening socket bound with SO_REUSEPORT, kernel
+ * spreads incoming connections between them. Connection stays with the worker that accepted it for its lifetime,
+ * so there is no rearm and no shared epoll, acceptors aren't started at all.
+ *
+ * Connections that have no activity for idle_timeout milliseconds are closed, 0 disables that.
+ *
+ * On stop workers quit serving events and connections are drained from the thread calling Join: responses to
+ * commands executed already are written out for at most drain_timeout milliseconds, then connections are closed.
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, bool reuseport = false,
+               uint32_t idle_timeout = 0, uint32_t drain_timeout = 5000);
     ~ServerImpl();
 
     // See Server.h
@@ -37,10 +50,22 @@ public:
     // See Server.h
     void Join() override;
 
+    // See Server.h
+    std::vector<int> Sockets() const override;
+
+    // See Server.h
+    Adoption Adopt(int socket) override;
+
 protected:
     void OnRun();
     void OnNewConnection();
 
+    // Flushes output of connections left by stopped workers and closes them or hands idle ones over
+    void Drain();
+
+    // Passes idle connections to the new process, they are closed here anyway
+    void HandOver(std::vector<Connection *> &connections);
+
 private:
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
@@ -50,9 +75,22 @@ private:
     // Read-only
     uint16_t listen_port;
 
+    // Every worker accepts connections itself on its own socket
+    const bool _reuseport;
+
+    // Milliseconds connection could stay idle
+    const uint32_t _idle_timeout;
+
+    // Milliseconds stop waits for responses to be written
+    const uint32_t _drain_timeout;
+
     // Socket to accept new connection on, shared between acceptors
     int _server_socket;
 
+    // Sockets and epoll instances of the workers in reuseport mode
+    std::vector<int> _worker_sockets;
+    std::vector<int> _worker_epoll_fds;
+
     // Threads that accepts new connections, each has private epoll instance
     // but share global server socket
     std::vector<std::thread> _acceptors;
@@ -60,14 +98,17 @@ private:
     // EPOLL instance shared between workers
     int _data_epoll_fd;
 
+    // Connections of the shared epoll or of every worker in reuseport mode
+    std::vector<std::shared_ptr<Registry>> _registries;
+
     // Curstom event "device" used to wakeup workers
     int _event_fd;
 
     // threads serving read/write requests
     std::vector<Worker> _workers;
 
-    // save connections so we can delete them and close sockets
-    std::set<Connection *> _connections;
+    // Number of connections adopted, they are spread between workers in reuseport mode
+    std::size_t _adopted;
 };
 
 } // namespace MTnonblock
@@ -3,6 +3,7 @@
 #include <cassert>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
 
 #include <netdb.h>
 #include <sys/epoll.h>
@@ -13,16 +14,33 @@
 
 #include <afina/logging/Service.h>
 
+#include "Balancer.h"
 #include "Connection.h"
+#include "Registry.h"
 #include "Utils.h"
 
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+// Milliseconds between connections given away by the same worker
+static const uint64_t balance_interval = 10;
+
+// Milliseconds connection stays with the worker it moved to, so hot ones don't bounce between workers
+static const uint64_t migrate_cooldown = 1000;
+
+// Epoll tags of server socket and mailbox events. Static objects: their addresses never move along with the
+// worker and never match a Connection
+static const char server_socket_tag = 0;
+static const char mailbox_tag = 0;
+
+static inline void *Tag(const char &tag) { return const_cast<char *>(&tag); }
+
 // See Worker.h
-Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1) {
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl,
+               std::shared_ptr<Registry> registry, std::shared_ptr<Balancer> balancer, std::size_t index)
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _server_socket(-1), _registry(registry),
+      _balancer(balancer), _index(index), _next_balance(0) {
     // TODO: implementation here
 }
 
@@ -32,25 +50,51 @@ Worker::~Worker() {
 }
 
 // See Worker.h
-Worker::Worker(Worker &&other) { *this = std::move(other); }
+Worker::Worker(Worker &&other) : isRunning(false) { *this = std::move(other); }
 
 // See Worker.h
 Worker &Worker::operator=(Worker &&other) {
+    // Running thread refers to the worker by address
+    assert(!other.isRunning && !isRunning);
     _pStorage = std::move(other._pStorage);
     _pLogging = std::move(other._pLogging);
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
     _epoll_fd = other._epoll_fd;
+    _server_socket = other._server_socket;
+    _registry = std::move(other._registry);
+    _balancer = std::move(other._balancer);
+    _index = other._index;
+    _next_balance = other._next_balance;
 
     other._epoll_fd = -1;
+    other._server_socket = -1;
     return *this;
 }
 
 // See Worker.h
-void Worker::Start(int epoll_fd) {
+void Worker::Start(int epoll_fd, int server_socket) {
     if (isRunning.exchange(true) == false) {
         assert(_epoll_fd == -1);
         _epoll_fd = epoll_fd;
+        _server_socket = server_socket;
+        if (_server_socket != -1) {
+            // Tag tells server socket events apart from connections and event_fd
+            struct epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = Tag(server_socket_tag);
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
+                throw std::runtime_error("Failed to add file descriptor to epoll");
+            }
+        }
+        if (_balancer != nullptr) {
+            struct epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = Tag(mailbox_tag);
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _balancer->Fd(_index), &event)) {
+                throw std::runtime_error("Failed to add mailbox descriptor to epoll");
+            }
+        }
         _logger = _pLogging->select("network.worker");
         _thread = std::thread(&Worker::OnRun, this);
     }
@@ -77,8 +121,18 @@ void Worker::OnRun() {
     int timeout = -1;
     std::array<struct epoll_event, 64> mod_list;
     while (isRunning) {
+        if (_balancer != nullptr) {
+            _balancer->Report(_index, 0);
+        }
         int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), timeout);
         _logger->debug("Worker wokeup: {} events", nmod);
+        uint64_t now = TimerWheel::Now();
+        if (_balancer != nullptr && nmod > 0) {
+            _balancer->Report(_index, nmod);
+        }
+
+        // Connection that was served last and could be given away
+        Connection *candidate = nullptr;
 
         for (int i = 0; i < nmod; i++) {
             struct epoll_event &current_event = mod_list[i];
@@ -90,8 +144,20 @@ void Worker::OnRun() {
                 continue;
             }
 
+            if (current_event.data.ptr == Tag(server_socket_tag)) {
+                OnAccept();
+                continue;
+            }
+
+            if (current_event.data.ptr == Tag(mailbox_tag)) {
+                OnMail();
+                continue;
+            }
+
             // Some connection gets new data
             Connection *pconn = static_cast<Connection *>(current_event.data.ptr);
+            pconn->_last_activity.store(now, std::memory_order_relaxed);
+            uint32_t events = pconn->_event.events;
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
                 pconn->DoRead();
                 pconn->DoWrite();
@@ -105,18 +171,28 @@ void Worker::OnRun() {
                 if (current_event.events & EPOLLIN) {
                     pconn->DoRead();
                 }
-                if (current_event.events & EPOLLOUT) {
+                // Responses to the burst just read are written right away, not on the next wakeup
+                if ((current_event.events & EPOLLOUT) || (pconn->_event.events & EPOLLOUT)) {
                     pconn->DoWrite();
                 }
             }
 
-            // Rearm connection
+            // Rearm connection, private one stays armed and needs update only when it wants other events
             if (pconn->isAlive()) {
-                pconn->_event.events |= EPOLLONESHOT;
+                if (_balancer != nullptr && pconn->_migrated + migrate_cooldown <= now) {
+                    candidate = pconn;
+                }
+                if (_server_socket == -1) {
+                    pconn->_event.events |= EPOLLONESHOT;
+                } else if (pconn->_event.events == events) {
+                    continue;
+                }
                 if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event)) {
                     pconn->OnError();
+                    _registry->Remove(pconn);
                     close(pconn->_socket);
                     delete pconn;
+                    candidate = nullptr;
                 }
             }
             // Or delete closed one
@@ -124,15 +200,97 @@ void Worker::OnRun() {
                 if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
                     std::cerr << "Failed to delete connection!" << std::endl;
                 }
+                _registry->Remove(pconn);
                 close(pconn->_socket);
                 delete pconn;
             }
         }
-        // TODO: Select timeout...
+
+        if (candidate != nullptr && nmod > 1) {
+            Rebalance(candidate, nmod, now);
+        }
+
+        // Idle connections are shut down and get deleted above once their hangup comes
+        timeout = _registry->Expire(now);
     }
     _logger->warn("Worker stopped");
 }
 
+// See Worker.h
+void Worker::OnMail() {
+    _mail.clear();
+    _balancer->Take(_index, _mail);
+    for (Connection *pc : _mail) {
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+            _logger->error("Failed to add migrated connection to epoll");
+            pc->OnError();
+            _registry->Remove(pc);
+            close(pc->_socket);
+            delete pc;
+        }
+    }
+}
+
+// See Worker.h
+void Worker::Rebalance(Connection *pc, uint32_t load, uint64_t now) {
+    if (now < _next_balance) {
+        return;
+    }
+    int peer = _balancer->Idle(_index);
+    if (peer == -1) {
+        return;
+    }
+    _next_balance = now + balance_interval;
+
+    // Level triggered epoll of the new owner reports whatever is pending on the socket
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
+        _logger->error("Failed to remove connection from epoll");
+        return;
+    }
+    _logger->debug("Give connection on descriptor {} to worker {}, {} are ready here", pc->_socket, peer, load);
+    pc->_migrated = now;
+    _balancer->Migrate(_index, peer, pc);
+}
+
+// See Worker.h
+void Worker::OnAccept() {
+    for (;;) {
+        struct sockaddr in_addr;
+        socklen_t in_len;
+
+        // No need to make these sockets non blocking since accept4() takes care of it.
+        in_len = sizeof in_addr;
+        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                _logger->error("Failed to accept socket");
+            }
+            break;
+        }
+
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        int retval =
+            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+        if (retval == 0) {
+            _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        }
+
+        // Connection lives in this worker only, so it is never rearmed
+        Connection *pc = new Connection(infd, _pStorage);
+        pc->Start();
+        if (pc->isAlive()) {
+            _registry->Add(pc);
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+                _registry->Remove(pc);
+                close(pc->_socket);
+                pc->OnError();
+
+                delete pc;
+            }
+        }
+    }
+}
+
 } // namespace MTnonblock
 } // namespace Network
 } // namespace Afina
@@ -2,8 +2,10 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_WORKER_H
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <thread>
+#include <vector>
 
 namespace spdlog {
 class logger;
@@ -20,6 +22,15 @@ class Service;
 namespace Network {
 namespace MTnonblock {
 
+// Forward declaration, see Registry.h
+class Registry;
+
+// Forward declaration, see Balancer.h
+class Balancer;
+
+// Forward declaration, see Connection.h
+class Connection;
+
 /**
  * # Thread running epoll
  * On Start spaws background thread that is doing epoll on the given server
@@ -27,7 +38,8 @@ namespace MTnonblock {
  */
 class Worker {
 public:
-    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl,
+           std::shared_ptr<Registry> registry, std::shared_ptr<Balancer> balancer = nullptr, std::size_t index = 0);
     ~Worker();
 
     Worker(Worker &&);
@@ -37,14 +49,18 @@ public:
      * Spaws new background thread that is doing epoll on the given server
      * socket. Once connection accepted it must be registered and being processed
      * on this thread
+     *
+     * If server_socket is given, epoll is private to the worker: thread accepts connections on that socket itself
+     * and keeps serving them until they are closed, without EPOLLONESHOT rearm. Such worker also exchanges
+     * connections with others through balancer, if it was given one
      */
-    void Start(int epoll_fd);
+    void Start(int epoll_fd, int server_socket = -1);
 
     /**
      * Signal background thread to stop. After that signal thread must stop to
-     * accept new connections and must stop read new commands from existing. Once
-     * all readed commands are executed and results are send back to client, thread
-     * must stop
+     * accept new connections and must stop read new commands from existing. Thread
+     * finishes events it has got already and exits, connections stay in the registry
+     * for the server to drain
      */
     void Stop();
 
@@ -60,6 +76,15 @@ protected:
      */
     void OnRun();
 
+    // Accepts all pending connections on the own server socket
+    void OnAccept();
+
+    // Registers connections other workers gave to this one
+    void OnMail();
+
+    // Gives connection to the idle worker, if there is one
+    void Rebalance(Connection *pc, uint32_t load, uint64_t now);
+
 private:
     Worker(Worker &) = delete;
     Worker &operator=(Worker &) = delete;
@@ -81,6 +106,20 @@ private:
 
     // EPOLL descriptor using for events processing
     int _epoll_fd;
+
+    // Socket to accept connections on or -1 if they come from acceptors through the shared epoll
+    int _server_socket;
+
+    // Idle timeouts of connections worker serves, shared along with epoll
+    std::shared_ptr<Registry> _registry;
+
+    // Workers exchanging connections and position of this one among them, nullptr if epoll is shared
+    std::shared_ptr<Balancer> _balancer;
+    std::size_t _index;
+
+    // Connections are given away no more often than once in balance_interval
+    uint64_t _next_balance;
+    std::vector<Connection *> _mail;
 };
 
 } // namespace MTnonblock
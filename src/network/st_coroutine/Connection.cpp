@@ -0,0 +1,109 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+// See Connection.h
+void Connection::Run() {
+    try {
+        while (Read() > 0) {
+            Process();
+            Flush();
+        }
+    } catch (std::runtime_error &ex) {
+        // Connection is closed by the server either way
+    }
+    state = State::Dead;
+}
+
+// See Connection.h
+ssize_t Connection::Read() {
+    for (;;) {
+        // Command could be parsed out already, its argument is read at once then
+        ssize_t new_bytes = _buffer.ReadFrom(_socket, arg_remains);
+        if (new_bytes >= 0) {
+            return new_bytes;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            Wait();
+        } else {
+            throw std::runtime_error(std::string(strerror(errno)));
+        }
+    }
+}
+
+// See Connection.h
+void Connection::Process() {
+    // Single block of data read from the socket could trigger inside actions a multiple times,
+    // for example:
+    // - read#0: [<command1 start>]
+    // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+    while (_buffer.Size() > 0) {
+        // There is no command yet
+        if (!command_to_execute) {
+            std::size_t parsed = 0;
+            if (parser.Parse(_buffer.Data(), _buffer.Size(), parsed)) {
+                // Here we are, current chunk finished some command, process it
+                command_to_execute = parser.Build(arg_remains);
+                if (arg_remains > 0) {
+                    arg_remains += 2;
+                }
+            }
+
+            // Parser might fail to consume any bytes, rest of the command is still on the way
+            if (parsed == 0) {
+                break;
+            }
+            _buffer.Consume(parsed);
+        }
+
+        // There is command, but we still wait for argument to arrive...
+        if (command_to_execute && arg_remains > 0) {
+            std::size_t to_read = std::min(arg_remains, _buffer.Size());
+            argument_for_command.append(_buffer.Data(), to_read);
+
+            _buffer.Consume(to_read);
+            arg_remains -= to_read;
+        }
+
+        // There is command & argument - RUN!
+        if (command_to_execute && arg_remains == 0) {
+            command_to_execute->Execute(*pStorage, argument_for_command, _output);
+            _output.Append("\r\n", 2);
+
+            // Prepare for the next command
+            command_to_execute.reset();
+            argument_for_command.resize(0);
+            parser.Reset();
+        }
+    }
+}
+
+// See Connection.h
+void Connection::Flush() {
+    while (!_output.Empty()) {
+        if (_output.WriteTo(_socket) >= 0) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            Wait();
+        } else {
+            throw std::runtime_error(std::string(strerror(errno)));
+        }
+    }
+}
+
+// See Connection.h
+void Connection::Wait() { _engine.sched(_loop); }
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
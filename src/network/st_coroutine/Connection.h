@@ -0,0 +1,97 @@
+#ifndef AFINA_NETWORK_ST_COROUTINE_CONNECTION_H
+#define AFINA_NETWORK_ST_COROUTINE_CONNECTION_H
+
+#include <cstring>
+#include <memory>
+
+#include <afina/Storage.h>
+#include <afina/coroutine/Engine.h>
+#include <afina/execute/Command.h>
+#include <protocol/Parser.h>
+
+#include <network/OutputBuffer.h>
+#include <network/ReadBuffer.h>
+
+#include <sys/epoll.h>
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+/**
+ * # Connection served by coroutine
+ * Connection is written in blocking style: read, parse, execute, write. Once socket would block coroutine gives
+ * control back to the event loop, which resumes it when epoll reports something for the socket. Socket is
+ * registered edge triggered once, so every resume simply retries the call that would block.
+ */
+class Connection {
+public:
+    enum class State { Alive, Dead };
+
+    static const int mask = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, Coroutine::Engine &engine, void *loop)
+        : _socket(s), _routine(nullptr), pStorage(ps), _engine(engine), _loop(loop) {
+        std::memset(&_event, 0, sizeof(struct epoll_event));
+        _event.events = mask;
+        _event.data.ptr = this;
+    }
+
+    inline bool isAlive() const { return state == State::Alive; }
+
+    /**
+     * Serves connection until client closes it or error happens, runs in the coroutine of the connection
+     */
+    void Run();
+
+protected:
+    /**
+     * Reads whatever is available, waits if there is nothing yet. Returns 0 once client closed connection
+     */
+    ssize_t Read();
+
+    /**
+     * Executes every complete command in the input buffer, responses are appended to the output
+     */
+    void Process();
+
+    /**
+     * Writes out the whole output, waits while socket is full
+     */
+    void Flush();
+
+    /**
+     * Gives control to the event loop until socket gets an event
+     */
+    void Wait();
+
+private:
+    friend class ServerImpl;
+
+    int _socket;
+    struct epoll_event _event;
+    State state = State::Alive;
+
+    // Coroutine serving connection
+    void *_routine;
+
+    // all we need to read and do commands
+    std::size_t arg_remains = 0;
+    Protocol::Parser parser;
+    std::string argument_for_command;
+    std::unique_ptr<Execute::Command> command_to_execute;
+    std::shared_ptr<Afina::Storage> pStorage;
+
+    ReadBuffer _buffer;
+    OutputBuffer _output;
+
+    // Engine connection runs in and coroutine of the event loop
+    Coroutine::Engine &_engine;
+    void *_loop;
+};
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_COROUTINE_CONNECTION_H
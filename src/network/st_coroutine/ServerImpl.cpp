@@ -0,0 +1,210 @@
+#include "ServerImpl.h"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include <network/Utils.h>
+
+#include "Connection.h"
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+                       std::size_t pool_size)
+    : Server(ps, pl), _server_socket(-1), _event_fd(-1), _engine(pool_size), _loop(nullptr) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start st_coroutine network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    _server_socket = ListenOrInherit(inheritedSockets, port, false);
+    DropInherited(inheritedSockets, *_logger);
+
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _work_thread = std::thread(&ServerImpl::OnRun, this);
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+
+    // Wakeup event loop, it finishes connections itself
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup event loop");
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    // Wait for work to be complete
+    _work_thread.join();
+    close(_event_fd);
+}
+
+// See Server.h
+std::vector<int> ServerImpl::Sockets() const { return std::vector<int>{_server_socket}; }
+
+// See ServerImpl.h
+void ServerImpl::OnRun() {
+    _logger->info("Start event loop");
+    _engine.start(&ServerImpl::Main, *this);
+
+    const Coroutine::PoolStats &stats = _engine.pool_stats();
+    _logger->warn("Event loop stopped, coroutine pool hits {} misses {}", stats.hits, stats.misses);
+}
+
+// See ServerImpl.h
+void ServerImpl::Main(ServerImpl &server) {
+    // Connections need the handle of the loop to give control back to
+    server._loop = server._engine.run(&ServerImpl::Loop, server);
+    server._engine.sched(server._loop);
+}
+
+// See ServerImpl.h
+void ServerImpl::Loop(ServerImpl &server) {
+    int epoll_descr = epoll_create1(0);
+    if (epoll_descr == -1) {
+        server._logger->error("Failed to create epoll file descriptor: {}", strerror(errno));
+        return;
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &server._server_socket;
+    struct epoll_event event2;
+    event2.events = EPOLLIN;
+    event2.data.ptr = &server._event_fd;
+    if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, server._server_socket, &event) ||
+        epoll_ctl(epoll_descr, EPOLL_CTL_ADD, server._event_fd, &event2)) {
+        server._logger->error("Failed to add file descriptor to epoll");
+        close(epoll_descr);
+        return;
+    }
+
+    bool run = true;
+    std::array<struct epoll_event, 64> mod_list;
+    while (run) {
+        int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), -1);
+        for (int i = 0; i < nmod; i++) {
+            if (mod_list[i].data.ptr == &server._event_fd) {
+                run = false;
+            } else if (mod_list[i].data.ptr == &server._server_socket) {
+                server.OnNewConnection(epoll_descr);
+            } else {
+                // Connection retries whatever would block, it is done once it returns here dead
+                Connection *pc = static_cast<Connection *>(mod_list[i].data.ptr);
+                if (pc->isAlive()) {
+                    server._engine.sched(pc->_routine);
+                }
+            }
+        }
+        server.OnFinished();
+    }
+
+    // Clients get end of stream, coroutines notice that and finish
+    for (Connection *pc : server._connections) {
+        if (pc->isAlive()) {
+            shutdown(pc->_socket, SHUT_RDWR);
+            server._engine.sched(pc->_routine);
+        }
+    }
+    server.OnFinished();
+    for (Connection *pc : server._connections) {
+        server._logger->error("Connection on descriptor {} is still served on stop", pc->_socket);
+    }
+
+    close(server._server_socket);
+    close(epoll_descr);
+}
+
+// See ServerImpl.h
+void ServerImpl::Serve(ServerImpl &server, Connection &conn) {
+    conn.Run();
+    server._finished.push_back(&conn);
+}
+
+// See ServerImpl.h
+void ServerImpl::OnNewConnection(int epoll_descr) {
+    for (;;) {
+        struct sockaddr in_addr;
+        socklen_t in_len = sizeof in_addr;
+        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                _logger->error("Failed to accept socket");
+            }
+            break;
+        }
+
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        int retval =
+            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+        if (retval == 0) {
+            _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        }
+
+        // Socket stays registered until it is closed, edge triggered events just resume the coroutine
+        Connection *pc = new Connection(infd, pStorage, _engine, _loop);
+        if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+            _logger->error("Failed to add connection to epoll");
+            close(pc->_socket);
+            delete pc;
+            continue;
+        }
+        _connections.insert(pc);
+
+        // Request usually comes along with connection, coroutine serves it right away
+        pc->_routine = _engine.run(&ServerImpl::Serve, *this, *pc);
+        _engine.sched(pc->_routine);
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::OnFinished() {
+    for (Connection *pc : _finished) {
+        _connections.erase(pc);
+        close(pc->_socket);
+        delete pc;
+    }
+    _finished.clear();
+}
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
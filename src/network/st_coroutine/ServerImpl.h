@@ -0,0 +1,88 @@
+#ifndef AFINA_NETWORK_ST_COROUTINE_SERVER_H
+#define AFINA_NETWORK_ST_COROUTINE_SERVER_H
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <afina/coroutine/Engine.h>
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+/**
+ * # Network resource manager implementation
+ * Single threaded epoll server where every connection is a coroutine. Event loop is a coroutine as well: it
+ * accepts connections, starts a coroutine for each of them and passes control to the one epoll reports event for.
+ * Connection coroutine gives control back once its socket would block.
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+               std::size_t pool_size = Coroutine::Engine::default_pool_size);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+    // See Server.h
+    std::vector<int> Sockets() const override;
+
+protected:
+    // Method executing by the network thread, runs engine until event loop is done
+    void OnRun();
+
+    // Accepts all pending connections and starts their coroutines
+    void OnNewConnection(int epoll_descr);
+
+    // Closes and deletes connections whose coroutines are done
+    void OnFinished();
+
+private:
+    // Coroutines: main one starts event loop, which in turn starts one per connection
+    static void Main(ServerImpl &server);
+    static void Loop(ServerImpl &server);
+    static void Serve(ServerImpl &server, Connection &conn);
+
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Socket to accept new connection on
+    int _server_socket;
+
+    // Curstom event "device" used to wakeup event loop
+    int _event_fd;
+
+    // IO thread
+    std::thread _work_thread;
+
+    Coroutine::Engine _engine;
+
+    // Coroutine of the event loop
+    void *_loop;
+
+    // Live connections and ones that are done but not deleted yet
+    std::set<Connection *> _connections;
+    std::vector<Connection *> _finished;
+};
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_COROUTINE_SERVER_H
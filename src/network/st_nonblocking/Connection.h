@@ -7,6 +7,10 @@
 #include <afina/execute/Command.h>
 #include <protocol/Parser.h>
 
+#include <network/OutputBuffer.h>
+#include <network/ReadBuffer.h>
+#include <network/TimerWheel.h>
+
 #include <sys/epoll.h>
 
 namespace Afina {
@@ -26,6 +30,7 @@ public:
     Connection(int s, std::shared_ptr<Afina::Storage> ps) : _socket(s), pStorage(ps) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
+        _timer.data = this;
     }
 
     inline bool isAlive() const {
@@ -58,12 +63,14 @@ private:
     std::shared_ptr<Afina::Storage> pStorage;
 
     // сохраняем состояние чтения
-    int _written_bytes;
-    int _readed_bytes;
-    int new_bytes;
-    char client_buffer[4096];
+    ReadBuffer _buffer;
+
+    // Responses waiting to be written, all of them go out with one call
+    OutputBuffer _output;
 
-    std::vector<std::string> results_to_write;
+    // Idle timeout, timer is moved forward lazily when it fires, so activity costs only a store
+    TimerWheel::Timer _timer;
+    uint64_t _last_activity;
 };
 
 } // namespace STnonblock
@@ -1,5 +1,6 @@
 #include "ServerImpl.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -21,15 +22,18 @@
 #include <afina/Storage.h>
 #include <afina/logging/Service.h>
 
+#include <network/Utils.h>
+
 #include "Connection.h"
-#include "Utils.h"
 
 namespace Afina {
 namespace Network {
 namespace STnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, uint32_t idle_timeout)
+    : Server(ps, pl), _idle_timeout(idle_timeout),
+      _timers(TimerWheel::Now(), std::max<uint64_t>(idle_timeout / 64, 1)) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -46,34 +50,8 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Unable to mask SIGPIPE");
     }
 
-    // Create server socket
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;         // IPv4
-    server_addr.sin_port = htons(port);       // TCP port number
-    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
-
-    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (_server_socket == -1) {
-        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
-    }
-
-    int opts = 1;
-    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
-    }
-
-    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
-    }
-
-    make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
-    }
+    _server_socket = ListenOrInherit(inheritedSockets, port, false);
+    DropInherited(inheritedSockets, *_logger);
 
     _event_fd = eventfd(0, EFD_NONBLOCK);
     if (_event_fd == -1) {
@@ -91,12 +69,6 @@ void ServerImpl::Stop() {
     if (eventfd_write(_event_fd, 1)) {
         throw std::runtime_error("Failed to wakeup workers");
     }
-    for (auto pc: _connections) {
-        close(pc->_socket);
-        delete pc;
-    }
-
-    close(_server_socket);
 }
 
 // See Server.h
@@ -128,10 +100,12 @@ void ServerImpl::OnRun() {
     }
 
     bool run = true;
+    int timeout = -1;
     std::array<struct epoll_event, 64> mod_list;
     while (run) {
-        int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), -1);
+        int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), timeout);
         _logger->debug("Acceptor wokeup: {} events", nmod);
+        uint64_t now = TimerWheel::Now();
 
         for (int i = 0; i < nmod; i++) {
             struct epoll_event &current_event = mod_list[i];
@@ -146,6 +120,7 @@ void ServerImpl::OnRun() {
 
             // That is some connection!
             Connection *pc = static_cast<Connection *>(current_event.data.ptr);
+            pc->_last_activity = now;
 
             auto old_mask = pc->_event.events;
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
@@ -161,38 +136,40 @@ void ServerImpl::OnRun() {
                 if (current_event.events & EPOLLIN) {
                     pc->DoRead();
                 }
-                if (current_event.events & EPOLLOUT) {
+                // Responses to the burst just read are written right away, not on the next wakeup
+                if ((current_event.events & EPOLLOUT) || (pc->_event.events & EPOLLOUT)) {
                     pc->DoWrite();
                 }
             }
 
             // Does it alive?
             if (!pc->isAlive()) {
-                if (epoll_ctl(epoll_descr, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to delete connection from epoll");
-                }
-
-                close(pc->_socket);
-                pc->OnClose();
-
-                _connections.erase(pc);
-                delete pc;
+                OnClose(epoll_descr, pc);
             } else if (pc->_event.events != old_mask) {
                 if (epoll_ctl(epoll_descr, EPOLL_CTL_MOD, pc->_socket, &pc->_event)) {
                     _logger->error("Failed to change connection event mask");
-
-                    close(pc->_socket);
-                    pc->OnClose();
-
-                    _connections.erase(pc);
-                    delete pc;
+                    OnClose(epoll_descr, pc);
                 }
             }
         }
+
+        timeout = OnTimers(epoll_descr, now);
+    }
+
+    // Connections belong to this thread, Stop only wakes it up
+    for (auto pc : _connections) {
+        close(pc->_socket);
+        delete pc;
     }
+    _connections.clear();
+    close(_server_socket);
+    close(epoll_descr);
     _logger->warn("Acceptor stopped");
 }
 
+// See ServerImpl.h
+std::vector<int> ServerImpl::Sockets() const { return std::vector<int>{_server_socket}; }
+
 void ServerImpl::OnNewConnection(int epoll_descr) {
     for (;;) {
         struct sockaddr in_addr;
@@ -228,13 +205,51 @@ void ServerImpl::OnNewConnection(int epoll_descr) {
         pc->Start();
         if (pc->isAlive()) {
             if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+                close(pc->_socket);
                 pc->OnError();
                 delete pc;
+                continue;
             }
         }
 
         _connections.insert(pc);
+        if (_idle_timeout > 0) {
+            pc->_last_activity = TimerWheel::Now();
+            _timers.Schedule(pc->_timer, pc->_last_activity + _idle_timeout);
+        }
+    }
+}
+
+void ServerImpl::OnClose(int epoll_descr, Connection *pc) {
+    if (epoll_ctl(epoll_descr, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
+        _logger->error("Failed to delete connection from epoll");
+    }
+
+    close(pc->_socket);
+    pc->OnClose();
+
+    // Timer leaves the wheel along with connection
+    _connections.erase(pc);
+    delete pc;
+}
+
+int ServerImpl::OnTimers(int epoll_descr, uint64_t now) {
+    if (_idle_timeout == 0) {
+        return -1;
+    }
+
+    _expired.clear();
+    _timers.Advance(now, _expired);
+    for (auto timer : _expired) {
+        Connection *pc = static_cast<Connection *>(timer->data);
+        if (pc->_last_activity + _idle_timeout > now) {
+            _timers.Schedule(pc->_timer, pc->_last_activity + _idle_timeout);
+        } else {
+            _logger->debug("Close idle connection on descriptor {}", pc->_socket);
+            OnClose(epoll_descr, pc);
+        }
     }
+    return _timers.Timeout(TimerWheel::Now());
 }
 
 } // namespace STnonblock
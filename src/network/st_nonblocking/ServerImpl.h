@@ -6,6 +6,7 @@
 #include <set>
 
 #include <afina/network/Server.h>
+#include <network/TimerWheel.h>
 #include "Connection.h"
 
 namespace spdlog {
@@ -22,10 +23,12 @@ class Worker;
 /**
  * # Network resource manager implementation
  * Epoll based server
+ *
+ * Connections that have no activity for idle_timeout milliseconds are closed, 0 disables that
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, uint32_t idle_timeout = 0);
     ~ServerImpl();
 
     // See Server.h
@@ -37,10 +40,18 @@ public:
     // See Server.h
     void Join() override;
 
+    // See Server.h
+    std::vector<int> Sockets() const override;
+
 protected:
     void OnRun();
     void OnNewConnection(int);
 
+    void OnClose(int, Connection *);
+
+    // Closes connections that stay idle for too long, returns epoll_wait timeout
+    int OnTimers(int, uint64_t);
+
 private:
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
@@ -61,6 +72,11 @@ private:
 
     // Vector for connections, so i can delete them
     std::set<Connection*> _connections;
+
+    // Idle timeouts of the connections
+    const uint32_t _idle_timeout;
+    TimerWheel _timers;
+    std::vector<TimerWheel::Timer *> _expired;
 };
 
 } // namespace STnonblock
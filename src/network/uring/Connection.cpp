@@ -0,0 +1,131 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// Terminates every response, shared by all connections
+static const std::shared_ptr<const std::string> line_end = std::make_shared<const std::string>("\r\n");
+
+// See Connection.h
+void Connection::Start() {
+    state = State::Alive;
+    command_to_execute.reset();
+    argument_for_command.resize(0);
+    parser.Reset();
+    results_to_write.clear();
+    arg_remains = 0;
+    _written_bytes = 0;
+    _recv_armed = false;
+    _sends_pending = 0;
+    _sent_bytes = 0;
+}
+
+// See Connection.h
+void Connection::OnError() { state = State::Dead; }
+
+// See Connection.h
+void Connection::OnClose() { state = State::Dead; }
+
+// See Connection.h
+void Connection::DoRead(const char *data, std::size_t size) {
+    // Single block of data could trigger inside actions a multiple times, see STnonblock::Connection::DoRead
+    while (size > 0) {
+        // There is no command yet
+        if (!command_to_execute) {
+            std::size_t parsed = 0;
+            if (parser.Parse(data, size, parsed)) {
+                command_to_execute = parser.Build(arg_remains);
+                if (arg_remains > 0) {
+                    arg_remains += 2;
+                }
+            }
+
+            if (parsed == 0) {
+                break;
+            }
+            data += parsed;
+            size -= parsed;
+        }
+
+        // There is command, but we still wait for argument to arrive...
+        if (command_to_execute && arg_remains > 0) {
+            std::size_t to_read = std::min(arg_remains, size);
+            argument_for_command.append(data, to_read);
+            data += to_read;
+            size -= to_read;
+            arg_remains -= to_read;
+        }
+
+        // There is command & argument - RUN!
+        if (command_to_execute && arg_remains == 0) {
+            command_to_execute->Execute(*pStorage, argument_for_command, results_to_write);
+            results_to_write.push_back(line_end);
+
+            // Prepare for the next command
+            command_to_execute.reset();
+            argument_for_command.resize(0);
+            parser.Reset();
+        }
+    }
+}
+
+// See Connection.h
+std::size_t Connection::SendMessages(std::size_t max_messages) const {
+    return std::min((results_to_write.size() + max_iov - 1) / max_iov, max_messages);
+}
+
+// See Connection.h
+std::size_t Connection::PrepareSend(std::size_t max_messages) {
+    assert(_sends_pending == 0);
+    std::size_t chunks = std::min(results_to_write.size(), max_messages * max_iov);
+    std::size_t messages = (chunks + max_iov - 1) / max_iov;
+
+    // Messages point into iov, so it is never reallocated while they are in flight
+    _iov.resize(chunks);
+    _msg.resize(messages);
+    for (std::size_t i = 0; i < chunks; i++) {
+        _iov[i].iov_base = const_cast<char *>(results_to_write[i]->data());
+        _iov[i].iov_len = results_to_write[i]->size();
+    }
+    if (chunks > 0) {
+        _iov[0].iov_base = static_cast<char *>(_iov[0].iov_base) + _written_bytes;
+        _iov[0].iov_len -= _written_bytes;
+    }
+
+    for (std::size_t m = 0; m < messages; m++) {
+        std::memset(&_msg[m], 0, sizeof(struct msghdr));
+        _msg[m].msg_iov = &_iov[m * max_iov];
+        _msg[m].msg_iovlen = std::min<std::size_t>(max_iov, chunks - m * max_iov);
+    }
+
+    _sends_pending = messages;
+    _sent_bytes = 0;
+    return messages;
+}
+
+// See Connection.h
+void Connection::OnSent(std::size_t bytes) {
+    assert(_sends_pending > 0);
+    _sent_bytes += bytes;
+    if (--_sends_pending > 0) {
+        return;
+    }
+
+    // Drop chunks sent completely, remember position in the first one left
+    std::size_t left = _written_bytes + _sent_bytes;
+    std::size_t done = 0;
+    while (done < results_to_write.size() && left >= results_to_write[done]->size()) {
+        left -= results_to_write[done]->size();
+        done++;
+    }
+    _written_bytes = left;
+    results_to_write.erase(results_to_write.begin(), results_to_write.begin() + done);
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
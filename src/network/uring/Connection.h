@@ -0,0 +1,95 @@
+#ifndef AFINA_NETWORK_URING_CONNECTION_H
+#define AFINA_NETWORK_URING_CONNECTION_H
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/execute/Command.h>
+#include <protocol/Parser.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * # Connection served through io_uring
+ * Connection never touches socket itself: worker feeds it with data kernel received into provided buffers and
+ * sends responses it has accumulated. Data is parsed right in the provided buffer, only command argument is copied.
+ */
+class Connection {
+public:
+    enum class State { Alive, Dead };
+
+    Connection(int s, std::shared_ptr<Afina::Storage> ps) : _socket(s), pStorage(ps) {}
+
+    inline bool isAlive() const { return state == State::Alive; }
+
+    void Start();
+
+protected:
+    void OnError();
+    void OnClose();
+
+    /**
+     * Parses received data and executes every complete command, responses are queued for sending
+     */
+    void DoRead(const char *data, std::size_t size);
+
+    /**
+     * Number of messages PrepareSend would make with the same limit
+     */
+    std::size_t SendMessages(std::size_t max_messages) const;
+
+    /**
+     * Prepares up to max_messages messages covering queued responses, each refers to at most max_iov chunks.
+     * Returns number of messages, they stay valid until OnSent is called for every one of them. Responses that
+     * didn't fit are left for the next round
+     */
+    std::size_t PrepareSend(std::size_t max_messages);
+
+    /**
+     * Accounts bytes sent by one of the prepared messages. Once all of them are complete sent chunks are dropped
+     */
+    void OnSent(std::size_t bytes);
+
+    inline bool WantsWrite() const { return _sends_pending == 0 && !results_to_write.empty(); }
+
+private:
+    friend class Worker;
+
+    static const int max_iov = 128;
+
+    int _socket;
+    State state = State::Alive;
+
+    // Multishot recv is posted and will produce more completions
+    bool _recv_armed;
+
+    // Messages being sent and bytes they have sent so far
+    std::size_t _sends_pending;
+    std::size_t _sent_bytes;
+    std::vector<struct iovec> _iov;
+    std::vector<struct msghdr> _msg;
+
+    // всё что нам как обычно надо для чтения и выполнения команд
+    std::size_t arg_remains;
+    Protocol::Parser parser;
+    std::string argument_for_command;
+    std::unique_ptr<Execute::Command> command_to_execute;
+    std::shared_ptr<Afina::Storage> pStorage;
+
+    // Responses waiting to be sent and number of bytes of the first one already sent
+    std::size_t _written_bytes;
+    Execute::Command::Chunks results_to_write;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_CONNECTION_H
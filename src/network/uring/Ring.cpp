@@ -0,0 +1,308 @@
+#include "Ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+static inline int io_uring_setup(unsigned entries, struct io_uring_params *p) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static inline int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static inline int io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T> static inline T *at(void *base, uint32_t offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+
+// See Ring.h
+Ring::Ring(unsigned entries) : _sq_ptr(MAP_FAILED), _cq_ptr(MAP_FAILED), _sqes(nullptr), _sq_local_tail(0) {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    _fd = io_uring_setup(entries, &params);
+    if (_fd < 0) {
+        throw std::runtime_error("Failed to setup io_uring: " + std::string(strerror(errno)));
+    }
+
+    _sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _sq_len = _cq_len = std::max(_sq_len, _cq_len);
+    }
+
+    _sq_ptr = mmap(nullptr, _sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_sq_ptr == MAP_FAILED) {
+        close(_fd);
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _cq_ptr = _sq_ptr;
+    } else {
+        _cq_ptr = mmap(nullptr, _cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+        if (_cq_ptr == MAP_FAILED) {
+            munmap(_sq_ptr, _sq_len);
+            close(_fd);
+            throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+        }
+    }
+
+    _sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(nullptr, _sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        if (_cq_ptr != _sq_ptr) {
+            munmap(_cq_ptr, _cq_len);
+        }
+        munmap(_sq_ptr, _sq_len);
+        close(_fd);
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+    _sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+    _sq_head = at<unsigned>(_sq_ptr, params.sq_off.head);
+    _sq_tail = at<unsigned>(_sq_ptr, params.sq_off.tail);
+    _sq_mask = *at<unsigned>(_sq_ptr, params.sq_off.ring_mask);
+    _sq_array = at<unsigned>(_sq_ptr, params.sq_off.array);
+    _sq_local_tail = *_sq_tail;
+
+    _cq_head = at<unsigned>(_cq_ptr, params.cq_off.head);
+    _cq_tail = at<unsigned>(_cq_ptr, params.cq_off.tail);
+    _cq_mask = *at<unsigned>(_cq_ptr, params.cq_off.ring_mask);
+    _cqes = at<struct io_uring_cqe>(_cq_ptr, params.cq_off.cqes);
+}
+
+// See Ring.h
+Ring::~Ring() {
+    munmap(_sqes, _sqes_len);
+    if (_cq_ptr != _sq_ptr) {
+        munmap(_cq_ptr, _cq_len);
+    }
+    munmap(_sq_ptr, _sq_len);
+    close(_fd);
+}
+
+// See Ring.h
+struct io_uring_sqe *Ring::GetSqe() {
+    if (!Reserve(1)) {
+        return nullptr;
+    }
+
+    unsigned index = _sq_local_tail & _sq_mask;
+    struct io_uring_sqe *sqe = &_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    _sq_array[index] = index;
+    _sq_local_tail++;
+    return sqe;
+}
+
+// See Ring.h
+bool Ring::Reserve(unsigned count) {
+    if (Free() >= count) {
+        return true;
+    }
+
+    // Kernel might refuse or take only a part, slot is reused only once sq_head has really moved past it
+    Submit();
+    return Free() >= count;
+}
+
+// See Ring.h
+unsigned Ring::Free() const { return Size() - (_sq_local_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE)); }
+
+// See Ring.h
+int Ring::Submit(unsigned wait_nr) {
+    __atomic_store_n(_sq_tail, _sq_local_tail, __ATOMIC_RELEASE);
+    unsigned to_submit = _sq_local_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+
+    int ret = io_uring_enter(_fd, to_submit, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+    if (ret < 0) {
+        return -errno;
+    }
+    return ret;
+}
+
+// See Ring.h
+struct io_uring_cqe *Ring::Peek() {
+    unsigned head = *_cq_head;
+    if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+    }
+    return &_cqes[head & _cq_mask];
+}
+
+// See Ring.h
+void Ring::Seen() { __atomic_store_n(_cq_head, *_cq_head + 1, __ATOMIC_RELEASE); }
+
+// See Ring.h
+bool Ring::Supports(const uint8_t *ops, std::size_t count) const {
+    const unsigned probe_ops = 256;
+    std::vector<char> buffer(sizeof(struct io_uring_probe) + probe_ops * sizeof(struct io_uring_probe_op));
+    struct io_uring_probe *probe = reinterpret_cast<struct io_uring_probe *>(buffer.data());
+    if (io_uring_register(_fd, IORING_REGISTER_PROBE, probe, probe_ops) < 0) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (ops[i] > probe->last_op || !(probe->ops[ops[i]].flags & IO_URING_OP_SUPPORTED)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// See Ring.h
+BufferRing::BufferRing(Ring &ring, uint16_t group, unsigned count, unsigned size, bool mapped)
+    : _ring(ring), _group(group), _count(count), _size(size), _mapped(mapped), _br(nullptr), _tail(0) {
+    if (count == 0 || (count & (count - 1)) != 0 || count > 32768) {
+        throw std::runtime_error("Number of provided buffers must be a power of 2");
+    }
+
+    // Descriptors and buffers in one mapping, descriptors ring must be page aligned
+    std::size_t ring_len = mapped ? count * sizeof(struct io_uring_buf) : 0;
+    _mem_len = ring_len + std::size_t(count) * size;
+    _mem = mmap(nullptr, _mem_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (_mem == MAP_FAILED) {
+        throw std::runtime_error("Failed to map provided buffers: " + std::string(strerror(errno)));
+    }
+    _data = static_cast<char *>(_mem) + ring_len;
+
+    if (!mapped) {
+        // All the buffers at once, they have consecutive ids
+        struct io_uring_sqe *sqe = _ring.GetSqe();
+        if (sqe == nullptr) {
+            munmap(_mem, _mem_len);
+            throw std::runtime_error("Failed to provide buffers: submission queue is full");
+        }
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = count;
+        sqe->addr = reinterpret_cast<uint64_t>(_data);
+        sqe->len = size;
+        sqe->off = 0;
+        sqe->buf_group = group;
+        return;
+    }
+
+    _br = static_cast<struct io_uring_buf_ring *>(_mem);
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(_br);
+    reg.ring_entries = count;
+    reg.bgid = group;
+    if (io_uring_register(_ring.fd(), IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        int err = errno;
+        munmap(_mem, _mem_len);
+        throw std::runtime_error("Failed to register provided buffers: " + std::string(strerror(err)));
+    }
+
+    for (unsigned bid = 0; bid < count; bid++) {
+        Recycle(bid);
+    }
+}
+
+// See Ring.h
+BufferRing::~BufferRing() {
+    if (_mapped) {
+        struct io_uring_buf_reg reg;
+        std::memset(&reg, 0, sizeof(reg));
+        reg.bgid = _group;
+        io_uring_register(_ring.fd(), IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    }
+    munmap(_mem, _mem_len);
+}
+
+// See Ring.h
+bool BufferRing::Works(bool mapped) {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == -1) {
+        return false;
+    }
+
+    int received = -1;
+    try {
+        Ring ring(8);
+        BufferRing buffers(ring, 0, 1, 64, mapped);
+        if (write(sv[1], "x", 1) == 1) {
+            struct io_uring_sqe *sqe = ring.GetSqe();
+            if (sqe == nullptr) {
+                throw std::runtime_error("Submission queue is full");
+            }
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = sv[0];
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = buffers.group();
+            sqe->user_data = 1;
+
+            while (received == -1 && ring.Submit(1) >= 0) {
+                for (struct io_uring_cqe *cqe = ring.Peek(); cqe != nullptr; cqe = ring.Peek()) {
+                    if (cqe->user_data == 1) {
+                        received = cqe->res;
+                    }
+                    ring.Seen();
+                }
+            }
+        }
+    } catch (std::runtime_error &ex) {
+    }
+
+    close(sv[0]);
+    close(sv[1]);
+    return received == 1;
+}
+
+// See Ring.h
+void BufferRing::Recycle(uint16_t bid) {
+    if (!_mapped) {
+        struct io_uring_sqe *sqe = _returned.empty() ? _ring.GetSqe() : nullptr;
+        if (sqe == nullptr) {
+            // Keep order, so the earlier returned buffers go first
+            _returned.push_back(bid);
+            return;
+        }
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = 1;
+        sqe->addr = reinterpret_cast<uint64_t>(Data(bid));
+        sqe->len = _size;
+        sqe->off = bid;
+        sqe->buf_group = _group;
+        return;
+    }
+
+    struct io_uring_buf *buf = &_br->bufs[_tail & (_count - 1)];
+    buf->addr = reinterpret_cast<uint64_t>(Data(bid));
+    buf->len = _size;
+    buf->bid = bid;
+
+    _tail++;
+    __atomic_store_n(&_br->tail, _tail, __ATOMIC_RELEASE);
+}
+
+// See Ring.h
+bool BufferRing::Flush() {
+    std::vector<uint16_t> returned;
+    returned.swap(_returned);
+    for (uint16_t bid : returned) {
+        Recycle(bid);
+    }
+    return _returned.empty();
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
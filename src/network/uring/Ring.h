@@ -0,0 +1,160 @@
+#ifndef AFINA_NETWORK_URING_RING_H
+#define AFINA_NETWORK_URING_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <linux/io_uring.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * # Minimal io_uring instance
+ * Maps submission and completion queues of the ring created by io_uring_setup(2) and talks to the kernel
+ * through raw syscalls, so no liburing is needed. Constructor throws std::runtime_error if the kernel has no
+ * io_uring or it is forbidden.
+ *
+ * That is NOT thread safe implementaiton!! Ring is owned by one thread
+ */
+class Ring {
+public:
+    explicit Ring(unsigned entries);
+    ~Ring();
+
+    /**
+     * Returns zeroed submission entry, queue is submitted to the kernel first if it is full. Returns nullptr if
+     * the kernel hasn't taken anything, e.g. it is busy because of completion queue overflow: completions must
+     * be reaped before retry
+     */
+    struct io_uring_sqe *GetSqe();
+
+    /**
+     * Makes sure the next count calls of GetSqe won't submit in between, so that linked chain reaches the kernel
+     * in one piece. Returns false if there is no room for count entries even after submit, same as GetSqe does.
+     * Count must not exceed Size()
+     */
+    bool Reserve(unsigned count);
+
+    /**
+     * Number of submission entries
+     */
+    inline unsigned Size() const { return _sq_mask + 1; }
+
+    /**
+     * Submits all prepared entries and waits until at least wait_nr completions are posted. Returns number
+     * of submitted entries or -errno
+     */
+    int Submit(unsigned wait_nr = 0);
+
+    /**
+     * Oldest posted completion or nullptr if queue is empty. Entry must be released by Seen before next one
+     * could be observed
+     */
+    struct io_uring_cqe *Peek();
+    void Seen();
+
+    /**
+     * Returns true if the kernel knows every given operation
+     */
+    bool Supports(const uint8_t *ops, std::size_t count) const;
+
+    inline int fd() const { return _fd; }
+
+private:
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    // Entries that could be prepared before the ones not yet consumed by the kernel get overwritten
+    unsigned Free() const;
+
+    int _fd;
+
+    // Mappings of the rings and submission entries
+    void *_sq_ptr;
+    std::size_t _sq_len;
+    void *_cq_ptr;
+    std::size_t _cq_len;
+    struct io_uring_sqe *_sqes;
+    std::size_t _sqes_len;
+
+    // Submission queue, head is moved by kernel
+    unsigned *_sq_head;
+    unsigned *_sq_tail;
+    unsigned _sq_mask;
+    unsigned *_sq_array;
+
+    // Entries prepared but not yet published to the kernel
+    unsigned _sq_local_tail;
+
+    // Completion queue, tail is moved by kernel
+    unsigned *_cq_head;
+    unsigned *_cq_tail;
+    unsigned _cq_mask;
+    struct io_uring_cqe *_cqes;
+};
+
+/**
+ * # Provided buffers
+ * Group of equal buffers given to the ring, recv with IOSQE_BUFFER_SELECT picks one of them when data arrives, so
+ * memory isn't pinned by idle connections. Buffer must be given back once its data is consumed.
+ *
+ * Buffers are published through a ring registered with IORING_REGISTER_PBUF_RING if mapped is true, that costs
+ * no submissions at all. Otherwise every buffer is handed over by IORING_OP_PROVIDE_BUFFERS request, completions
+ * of such requests carry zero user_data.
+ */
+class BufferRing {
+public:
+    BufferRing(Ring &ring, uint16_t group, unsigned count, unsigned size, bool mapped);
+    ~BufferRing();
+
+    /**
+     * Checks that recv really gets buffers of the given kind: some kernels accept registration of the mapped
+     * ring but never pick buffers out of it
+     */
+    static bool Works(bool mapped);
+
+    inline uint16_t group() const { return _group; }
+
+    inline char *Data(uint16_t bid) const { return _data + std::size_t(bid) * _size; }
+
+    /**
+     * Gives buffer back to the kernel. If there is no submission entry for it right now, buffer is kept until
+     * the next Flush
+     */
+    void Recycle(uint16_t bid);
+
+    /**
+     * Gives back buffers Recycle has failed to, returns false if some are still left
+     */
+    bool Flush();
+
+private:
+    BufferRing(const BufferRing &) = delete;
+    BufferRing &operator=(const BufferRing &) = delete;
+
+    Ring &_ring;
+    const uint16_t _group;
+    const unsigned _count;
+    const unsigned _size;
+    const bool _mapped;
+
+    // Ring of descriptors, if mapped, followed by buffers themselves
+    void *_mem;
+    std::size_t _mem_len;
+    struct io_uring_buf_ring *_br;
+    char *_data;
+
+    uint16_t _tail;
+
+    // Buffers waiting for submission entry to be given back by
+    std::vector<uint16_t> _returned;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_RING_H
@@ -0,0 +1,132 @@
+#include "ServerImpl.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/logging/Service.h>
+
+#include "Ring.h"
+#include "Worker.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// See ServerImpl.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _event_fd(-1) {}
+
+// See ServerImpl.h
+ServerImpl::~ServerImpl() {}
+
+// See ServerImpl.h
+bool ServerImpl::Supported() {
+    static const uint8_t ops[] = {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SENDMSG, IORING_OP_POLL_ADD,
+                                  IORING_OP_PROVIDE_BUFFERS};
+    try {
+        Ring ring(8);
+        if (!ring.Supports(ops, sizeof(ops))) {
+            return false;
+        }
+    } catch (std::runtime_error &ex) {
+        return false;
+    }
+    return BufferRing::Works(false);
+}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    bool mapped_buffers = BufferRing::Works(true);
+    if (!mapped_buffers) {
+        _logger->warn("Provided buffer ring doesn't work, buffers are provided by requests");
+    }
+
+    // Acceptors aren't needed, every worker accepts connections on its own socket
+    _workers.reserve(n_workers);
+    for (uint32_t i = 0; i < n_workers; i++) {
+        int server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (server_socket == -1) {
+            throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+        }
+
+        int opts = 1;
+        if (setsockopt(server_socket, SOL_SOCKET, SO_KEEPALIVE, &opts, sizeof(opts)) == -1 ||
+            setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1) {
+            close(server_socket);
+            throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+        }
+
+        if (bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+            close(server_socket);
+            throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+        }
+
+        if (listen(server_socket, SOMAXCONN) == -1) {
+            close(server_socket);
+            throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+        }
+        _server_sockets.push_back(server_socket);
+
+        _workers.emplace_back(pStorage, pLogging);
+        _workers.back().Start(server_socket, _event_fd, mapped_buffers);
+    }
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+    for (auto &w : _workers) {
+        w.Stop();
+    }
+
+    // Wakeup threads that are sleep in io_uring_enter
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup workers");
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    for (auto &w : _workers) {
+        w.Join();
+    }
+
+    // Sockets are still referenced by accepts in flight until workers tear their rings down
+    for (int socket : _server_sockets) {
+        close(socket);
+    }
+    close(_event_fd);
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,62 @@
+#ifndef AFINA_NETWORK_URING_SERVER_H
+#define AFINA_NETWORK_URING_SERVER_H
+
+#include <vector>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// Forward declaration, see Worker.h
+class Worker;
+
+/**
+ * # Network resource manager implementation
+ * io_uring based server. Every worker has its own ring and its own listening socket bound with SO_REUSEPORT,
+ * there are no acceptor threads: connections are accepted by the ring itself.
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    /**
+     * Returns true if the kernel provides everything server relies on: io_uring itself, accept, recv, sendmsg
+     * and poll operations and provided buffers
+     */
+    static bool Supported();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+private:
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Sockets to accept new connection on, one per worker
+    std::vector<int> _server_sockets;
+
+    // Curstom event "device" used to wakeup workers
+    int _event_fd;
+
+    // threads serving read/write requests
+    std::vector<Worker> _workers;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_SERVER_H
@@ -0,0 +1,322 @@
+#include "Worker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/logging/Service.h>
+
+#include "Connection.h"
+#include "Ring.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// Ring size and provided buffers of every worker
+static const unsigned ring_entries = 4096;
+static const unsigned buffers_count = 1024;
+static const unsigned buffer_size = 4096;
+static const uint16_t buffers_group = 0;
+
+// Operation is kept in low bits of user_data, connection address in the rest
+enum Op : uint64_t { op_accept = 1, op_wake = 2, op_recv = 3, op_send = 4, op_mask = 7 };
+
+static inline uint64_t pack(Connection *pc, Op op) { return reinterpret_cast<uint64_t>(pc) | op; }
+
+// See Worker.h
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _server_socket(-1), _event_fd(-1), _multishot_accept(true),
+      _multishot_recv(true), _accept_deferred(false), _wait_deferred(false) {}
+
+// See Worker.h
+Worker::~Worker() {}
+
+// See Worker.h
+Worker::Worker(Worker &&other) { *this = std::move(other); }
+
+// See Worker.h
+Worker &Worker::operator=(Worker &&other) {
+    _pStorage = std::move(other._pStorage);
+    _pLogging = std::move(other._pLogging);
+    _logger = std::move(other._logger);
+    _thread = std::move(other._thread);
+    _server_socket = other._server_socket;
+    _event_fd = other._event_fd;
+    _ring = std::move(other._ring);
+    _buffers = std::move(other._buffers);
+    _multishot_accept = other._multishot_accept;
+    _multishot_recv = other._multishot_recv;
+    _accept_deferred = other._accept_deferred;
+    _wait_deferred = other._wait_deferred;
+
+    other._server_socket = -1;
+    other._event_fd = -1;
+    return *this;
+}
+
+// See Worker.h
+void Worker::Start(int server_socket, int event_fd, bool mapped_buffers) {
+    if (isRunning.exchange(true) == false) {
+        _server_socket = server_socket;
+        _event_fd = event_fd;
+        _logger = _pLogging->select("network.worker");
+
+        _ring.reset(new Ring(ring_entries));
+        _buffers.reset(new BufferRing(*_ring, buffers_group, buffers_count, buffer_size, mapped_buffers));
+        _thread = std::thread(&Worker::OnRun, this);
+    }
+}
+
+// See Worker.h
+void Worker::Stop() { isRunning = false; }
+
+// See Worker.h
+void Worker::Join() {
+    assert(_thread.joinable());
+    _thread.join();
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    _logger->trace("OnRun");
+
+    _accept_deferred = !Accept();
+    _wait_deferred = !WaitEvent();
+    while (isRunning) {
+        // Operations that found submission queue full are retried once completions got reaped
+        if (_accept_deferred) {
+            _accept_deferred = !Accept();
+        }
+        if (_wait_deferred) {
+            _wait_deferred = !WaitEvent();
+        }
+        bool flushed = _buffers->Flush();
+
+        // Responses of the whole batch go out together, connections that don't fit stay for the next round
+        std::vector<Connection *> ready;
+        ready.swap(_ready);
+        for (Connection *pc : ready) {
+            if (!pc->isAlive()) {
+                continue;
+            }
+            bool deferred = !pc->_recv_armed && !Recv(pc);
+            if (pc->WantsWrite() && !Send(pc)) {
+                deferred = true;
+            }
+            if (deferred) {
+                _ready.push_back(pc);
+            }
+        }
+
+        // Don't sleep if something is still waiting for room in the queue
+        bool idle = _ready.empty() && !_accept_deferred && !_wait_deferred && flushed;
+        int ret = _ring->Submit(idle ? 1 : 0);
+        if (ret < 0 && ret != -EINTR && ret != -EBUSY && ret != -EAGAIN) {
+            _logger->error("Failed to submit to io_uring: {}", strerror(-ret));
+            break;
+        }
+
+        for (struct io_uring_cqe *cqe = _ring->Peek(); cqe != nullptr; cqe = _ring->Peek()) {
+            uint64_t user_data = cqe->user_data;
+            int res = cqe->res;
+            uint32_t flags = cqe->flags;
+            _ring->Seen();
+
+            Connection *pc = reinterpret_cast<Connection *>(user_data & ~uint64_t(op_mask));
+            switch (user_data & op_mask) {
+            case op_accept:
+                OnAccept(res, flags);
+                break;
+            case op_wake:
+                // Server signals us to process some state change, react on it in OUTHER loop
+                _wait_deferred = !WaitEvent();
+                break;
+            case op_recv:
+                OnRecv(pc, res, flags);
+                break;
+            case op_send:
+                OnSend(pc, res);
+                break;
+            default:
+                // Buffers given back to the kernel
+                break;
+            }
+        }
+    }
+
+    // Ring teardown cancels all operations still in flight, only then connections could go
+    _buffers.reset();
+    _ring.reset();
+    for (Connection *pc : _connections) {
+        close(pc->_socket);
+        delete pc;
+    }
+    _connections.clear();
+    _logger->warn("Worker stopped");
+}
+
+bool Worker::Accept() {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    if (sqe == nullptr) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = _server_socket;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    if (_multishot_accept) {
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    }
+    sqe->user_data = pack(nullptr, op_accept);
+    return true;
+}
+
+bool Worker::Recv(Connection *pc) {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    if (sqe == nullptr) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = pc->_socket;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = _buffers->group();
+    if (_multishot_recv) {
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+    }
+    sqe->user_data = pack(pc, op_recv);
+    pc->_recv_armed = true;
+    return true;
+}
+
+bool Worker::Send(Connection *pc) {
+    // Whole chain has to be submitted at once, kernel breaks the link at the submission boundary and then
+    // the rest could be sent concurrently with the first part
+    std::size_t messages = pc->SendMessages(_ring->Size());
+    if (!_ring->Reserve(messages)) {
+        return false;
+    }
+    pc->PrepareSend(messages);
+    for (std::size_t m = 0; m < messages; m++) {
+        struct io_uring_sqe *sqe = _ring->GetSqe();
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = pc->_socket;
+        sqe->addr = reinterpret_cast<uint64_t>(&pc->_msg[m]);
+        sqe->len = 1;
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        // Chain keeps responses in order, short send cancels the rest and they are resent once chain completes
+        if (m + 1 < messages) {
+            sqe->flags = IOSQE_IO_LINK;
+        }
+        sqe->user_data = pack(pc, op_send);
+    }
+    return true;
+}
+
+bool Worker::WaitEvent() {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    if (sqe == nullptr) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = _event_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = pack(nullptr, op_wake);
+    return true;
+}
+
+void Worker::OnAccept(int res, uint32_t flags) {
+    if (res >= 0) {
+        _logger->debug("Accepted connection on descriptor {}", res);
+
+        Connection *pc = new Connection(res, _pStorage);
+        pc->Start();
+        _connections.insert(pc);
+        if (!Recv(pc)) {
+            _ready.push_back(pc);
+        }
+    } else if (res == -EINVAL && _multishot_accept) {
+        _logger->warn("Multishot accept isn't supported, fallback to single shot");
+        _multishot_accept = false;
+    } else if (res != -ECANCELED) {
+        _logger->error("Failed to accept socket: {}", strerror(-res));
+    }
+
+    if (!(flags & IORING_CQE_F_MORE) && res != -ECANCELED && res != -EBADF) {
+        _accept_deferred = !Accept();
+    }
+}
+
+void Worker::OnRecv(Connection *pc, int res, uint32_t flags) {
+    if (!(flags & IORING_CQE_F_MORE)) {
+        pc->_recv_armed = false;
+    }
+
+    if (res > 0) {
+        assert(flags & IORING_CQE_F_BUFFER);
+        uint16_t bid = flags >> IORING_CQE_BUFFER_SHIFT;
+        if (pc->isAlive()) {
+            try {
+                pc->DoRead(_buffers->Data(bid), res);
+            } catch (std::runtime_error &ex) {
+                _logger->error("Failed to process connection on descriptor {}: {}", pc->_socket, ex.what());
+                pc->OnError();
+            }
+        }
+        _buffers->Recycle(bid);
+    } else if (res == 0) {
+        pc->OnClose();
+    } else if (res == -EINVAL && _multishot_recv) {
+        _logger->warn("Multishot recv isn't supported, fallback to single shot");
+        _multishot_recv = false;
+    } else if (res != -ENOBUFS) {
+        // Running out of provided buffers isn't an error, recv is just posted again
+        pc->OnError();
+    }
+
+    if (!pc->isAlive()) {
+        Release(pc);
+        return;
+    }
+    // Recv which doesn't fit into the queue is posted along with responses
+    if ((!pc->_recv_armed && !Recv(pc)) || pc->WantsWrite()) {
+        _ready.push_back(pc);
+    }
+}
+
+void Worker::OnSend(Connection *pc, int res) {
+    if (res < 0 && res != -ECANCELED) {
+        pc->OnError();
+    }
+    pc->OnSent(res > 0 ? res : 0);
+
+    if (!pc->isAlive()) {
+        Release(pc);
+    } else if (pc->WantsWrite()) {
+        _ready.push_back(pc);
+    }
+}
+
+void Worker::Release(Connection *pc) {
+    // Wake up pending recv, it completes with no more data
+    shutdown(pc->_socket, SHUT_RDWR);
+    if (pc->_recv_armed || pc->_sends_pending > 0) {
+        return;
+    }
+
+    close(pc->_socket);
+    _connections.erase(pc);
+    _ready.erase(std::remove(_ready.begin(), _ready.end(), pc), _ready.end());
+    delete pc;
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,127 @@
+#ifndef AFINA_NETWORK_URING_WORKER_H
+#define AFINA_NETWORK_URING_WORKER_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+namespace Logging {
+class Service;
+}
+
+namespace Network {
+namespace Uring {
+
+class Connection;
+class Ring;
+class BufferRing;
+
+/**
+ * # Thread running io_uring
+ * Owns a ring and a group of provided buffers. Connections are accepted by multishot accept on the worker's own
+ * server socket and stay with the worker until closed, data comes in by multishot recv into provided buffers.
+ * Responses produced by a batch of completions are sent by one sendmsg per connection, or by a chain of linked
+ * ones if there are too many chunks for a single message.
+ *
+ * Kernels without multishot operations are served by single shot ones rearmed after every completion.
+ */
+class Worker {
+public:
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
+    ~Worker();
+
+    Worker(Worker &&);
+    Worker &operator=(Worker &&);
+
+    /**
+     * Creates ring and spawns new background thread accepting connections on the given server socket. Thread
+     * wakes up once event_fd becomes readable to check whether it should stop. Throws std::runtime_error if the
+     * ring couldn't be set up. See BufferRing about mapped_buffers
+     */
+    void Start(int server_socket, int event_fd, bool mapped_buffers);
+
+    /**
+     * Signal background thread to stop, it must be woken up by event_fd then. Connections are closed as is
+     */
+    void Stop();
+
+    /**
+     * Blocks calling thread until background one for this worker is actually
+     * been destoryed
+     */
+    void Join();
+
+protected:
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+
+private:
+    Worker(Worker &) = delete;
+    Worker &operator=(Worker &) = delete;
+
+    // Prepare submission entries of the operations, return false if there is no room in the queue right now
+    bool Accept();
+    bool Recv(Connection *pc);
+    bool Send(Connection *pc);
+    bool WaitEvent();
+
+    // Handle completions
+    void OnAccept(int res, uint32_t flags);
+    void OnRecv(Connection *pc, int res, uint32_t flags);
+    void OnSend(Connection *pc, int res);
+
+    // Deletes dead connection once kernel has no operations on it left
+    void Release(Connection *pc);
+
+    // afina services
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // afina services
+    std::shared_ptr<Afina::Logging::Service> _pLogging;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Flag signals that thread should continue to operate
+    std::atomic<bool> isRunning;
+
+    // Thread serving requests in this worker
+    std::thread _thread;
+
+    int _server_socket;
+    int _event_fd;
+
+    std::unique_ptr<Ring> _ring;
+    std::unique_ptr<BufferRing> _buffers;
+
+    // Multishot operations are supported by the kernel, turned off once it rejects them
+    bool _multishot_accept;
+    bool _multishot_recv;
+
+    // Accept and wakeup poll that didn't fit into the queue, posted again on the next round
+    bool _accept_deferred;
+    bool _wait_deferred;
+
+    // Connections served by the worker
+    std::unordered_set<Connection *> _connections;
+
+    // Connections got responses during current batch of completions, or still need recv or send posted
+    std::vector<Connection *> _ready;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+#endif // AFINA_NETWORK_URING_WORKER_H
@@ -55,6 +55,11 @@ public:
 
     inline const std::string &Name() const { return name; }
 
+    /**
+     * True if parser got no input since the last reset
+     */
+    inline bool Clean() const { return state == State::sName && name.empty(); }
+
 private:
     /**
      * State of the command parser. Prefixes are:
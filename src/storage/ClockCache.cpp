@@ -0,0 +1,172 @@
+#include "ClockCache.h"
+
+#include <mutex>
+
+namespace Afina {
+namespace Backend {
+
+// See ClockCache.h
+ClockCache::ClockCache(size_t max_size)
+    : _max_size(max_size), _current_size(0), _ring(new clock_slot[16]), _ring_capacity(16), _ring_used(0),
+      _hand(0) {}
+
+// See ClockCache.h
+ClockCache::~ClockCache() {
+    for (std::size_t i = 0; i < _ring_used; i++) {
+        delete _ring[i].node;
+    }
+}
+
+// See ClockCache.h
+bool ClockCache::Put(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    std::size_t hash = _index.Hash(key);
+    clock_node *node = _index.Find(key, hash);
+    if (node == nullptr) {
+        return PutNew(key, value, hash);
+    }
+    return PutOld(node, value);
+}
+
+// See ClockCache.h
+bool ClockCache::PutIfAbsent(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    std::size_t hash = _index.Hash(key);
+    if (_index.Find(key, hash) != nullptr) {
+        return false;
+    }
+    return PutNew(key, value, hash);
+}
+
+// See ClockCache.h
+bool ClockCache::Set(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    clock_node *node = _index.Find(key, _index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+    return PutOld(node, value);
+}
+
+// See ClockCache.h
+bool ClockCache::Delete(const std::string &key) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    clock_node *node = _index.Find(key, _index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+
+    Remove(node);
+    return true;
+}
+
+// See ClockCache.h
+bool ClockCache::Get(const std::string &key, std::string &value) {
+    Concurrency::SharedLock<Concurrency::SharedMutex> lock(_mutex);
+    clock_node *node = _index.Find(key, _index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+
+    value = node->value;
+
+    // Check before store: hot entries keep bit set, so there is no write and their cache line stays shared
+    std::atomic<bool> &referenced = _ring[node->slot].referenced;
+    if (!referenced.load(std::memory_order_relaxed)) {
+        referenced.store(true, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool ClockCache::PutOld(clock_node *node, const std::string &value) {
+    _ring[node->slot].referenced.store(true, std::memory_order_relaxed);
+    while (_current_size - node->value.size() + value.size() > _max_size) {
+        EvictOne(node);
+    }
+
+    _current_size = _current_size - node->value.size() + value.size();
+    node->value = value;
+    return true;
+}
+
+bool ClockCache::PutNew(const std::string &key, const std::string &value, std::size_t hash) {
+    const std::size_t insert_memory = key.size() + value.size();
+    while (_max_size - _current_size < insert_memory) {
+        EvictOne(nullptr);
+    }
+
+    clock_node *node = new clock_node(key, value, hash);
+    node->slot = AcquireSlot();
+    _ring[node->slot].node = node;
+    _ring[node->slot].referenced.store(false, std::memory_order_relaxed);
+
+    _index.Insert(node);
+    _current_size += insert_memory;
+    return true;
+}
+
+void ClockCache::EvictOne(const clock_node *keep) {
+    // Each sweep clears bits, so at most two full turns are needed to find a victim
+    for (;;) {
+        if (_hand >= _ring_used) {
+            _hand = 0;
+        }
+
+        clock_slot &s = _ring[_hand++];
+        if (s.node == nullptr || s.node == keep) {
+            continue;
+        }
+
+        if (s.referenced.load(std::memory_order_relaxed)) {
+            s.referenced.store(false, std::memory_order_relaxed);
+        } else {
+            Remove(s.node);
+            return;
+        }
+    }
+}
+
+void ClockCache::Remove(clock_node *node) {
+    _ring[node->slot].node = nullptr;
+    _ring[node->slot].referenced.store(false, std::memory_order_relaxed);
+    _free_slots.push_back(node->slot);
+
+    _index.Erase(node);
+    _current_size -= node->key.size() + node->value.size();
+    delete node;
+}
+
+std::size_t ClockCache::AcquireSlot() {
+    if (!_free_slots.empty()) {
+        std::size_t slot = _free_slots.back();
+        _free_slots.pop_back();
+        return slot;
+    }
+
+    if (_ring_used == _ring_capacity) {
+        // Atomics aren't movable, so ring grows by hand. Done under exclusive lock, so nobody reads old ring
+        std::unique_ptr<clock_slot[]> ring(new clock_slot[_ring_capacity * 2]);
+        for (std::size_t i = 0; i < _ring_used; i++) {
+            ring[i].node = _ring[i].node;
+            ring[i].referenced.store(_ring[i].referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        _ring.swap(ring);
+        _ring_capacity *= 2;
+    }
+    return _ring_used++;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,98 @@
+#ifndef AFINA_STORAGE_CLOCK_CACHE_H
+#define AFINA_STORAGE_CLOCK_CACHE_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/SharedMutex.h>
+
+#include "HashIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK (second chance) cache
+ * Entries occupy slots of a contiguous ring, each slot has a reference bit. Hit only sets the bit, so Get runs
+ * under shared lock and never writes anything but that bit. To free space the hand sweeps the ring: referenced
+ * slot loses its bit and survives, unreferenced one is evicted.
+ *
+ * Get is shared, Put/PutIfAbsent/Set/Delete take the lock exclusively
+ */
+class ClockCache : public Afina::Storage {
+public:
+    ClockCache(size_t max_size = 1024);
+    ~ClockCache();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+private:
+    struct clock_node {
+        const std::string key;
+        std::string value;
+        const std::size_t hash;
+
+        // Position in the ring
+        std::size_t slot;
+
+        clock_node(const std::string &key, const std::string &value, std::size_t hash)
+            : key(key), value(value), hash(hash), slot(0) {}
+
+        inline bool KeyEquals(const std::string &other) const { return key == other; }
+    };
+
+    struct clock_slot {
+        clock_node *node;
+        std::atomic<bool> referenced;
+    };
+
+    bool PutOld(clock_node *node, const std::string &value);
+    bool PutNew(const std::string &key, const std::string &value, std::size_t hash);
+
+    // Move the hand until some node, except the given one, could be evicted and evict it
+    void EvictOne(const clock_node *keep);
+
+    // Free slot and destroy node in it
+    void Remove(clock_node *node);
+
+    // Returns index of an empty slot, grows the ring if necessary
+    std::size_t AcquireSlot();
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    const std::size_t _max_size;
+    std::size_t _current_size;
+
+    // Ring of slots, first _ring_used are ever been used, some of them could be empty
+    std::unique_ptr<clock_slot[]> _ring;
+    std::size_t _ring_capacity;
+    std::size_t _ring_used;
+    std::vector<std::size_t> _free_slots;
+
+    // Clock hand, position of the next eviction candidate
+    std::size_t _hand;
+
+    HashIndex<clock_node> _index;
+    Concurrency::SharedMutex _mutex;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CLOCK_CACHE_H
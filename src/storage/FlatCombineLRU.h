@@ -0,0 +1,145 @@
+#ifndef AFINA_STORAGE_FLAT_COMBINE_LRU_H
+#define AFINA_STORAGE_FLAT_COMBINE_LRU_H
+
+#include <exception>
+#include <memory>
+#include <string>
+
+#include <afina/concurrency/FlatCombine.h>
+
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleLRU serialized by flat combining
+ * Same semantic as ThreadSafeSimplLRU, but instead of every thread taking the mutex in turn, calls are published
+ * to the combiner and whichever thread becomes it applies the whole batch to SimpleLRU. Under high contention the
+ * list and index stay hot in one cache and there is no sleeping on the lock; with a single client it only adds
+ * the cost of publication.
+ */
+class FlatCombineLRU : public SimpleLRU {
+public:
+    FlatCombineLRU(size_t max_size = 1024, size_t slots = 64)
+        : SimpleLRU(max_size), _combine([this](operation *const *ops, std::size_t count) { Execute(ops, count); },
+                                        slots) {}
+    ~FlatCombineLRU() {}
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value) override {
+        operation op(operation::Put, key, &value);
+        return Apply(op);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        operation op(operation::PutIfAbsent, key, &value);
+        return Apply(op);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value) override {
+        operation op(operation::Set, key, &value);
+        return Apply(op);
+    }
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key) override {
+        operation op(operation::Delete, key, nullptr);
+        return Apply(op);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value) override {
+        operation op(operation::Get, key, nullptr);
+        op.out = &value;
+        return Apply(op);
+    }
+
+    // see SimpleLRU.h
+    bool GetView(const std::string &key, std::shared_ptr<const std::string> &value) override {
+        operation op(operation::GetView, key, nullptr);
+        op.view = &value;
+        return Apply(op);
+    }
+
+    /**
+     * Average number of calls applied by one combiner pass so far
+     */
+    double BatchSize() const {
+        std::size_t batches = _combine.Batches();
+        return batches == 0 ? 0 : double(_combine.Operations()) / batches;
+    }
+
+private:
+    // Call published by client, lives on its stack until combiner applies it
+    struct operation {
+        enum kind { Put, PutIfAbsent, Set, Delete, Get, GetView };
+
+        operation(kind k, const std::string &key, const std::string *value)
+            : type(k), key(key), value(value), out(nullptr), view(nullptr), result(false) {}
+
+        kind type;
+        const std::string &key;
+        const std::string *value;
+        std::string *out;
+        std::shared_ptr<const std::string> *view;
+        bool result;
+
+        // Set if SimpleLRU has thrown on this call, the rest of the batch goes on
+        std::exception_ptr error;
+    };
+
+    // Publishes call and waits for its result
+    bool Apply(operation &op) {
+        _combine.Apply(op);
+        if (op.error) {
+            std::rethrow_exception(op.error);
+        }
+        return op.result;
+    }
+
+    // Applies batch to SimpleLRU, called by combiner only
+    void Execute(operation *const *ops, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            operation &op = *ops[i];
+            try {
+                Execute(op);
+            } catch (...) {
+                op.error = std::current_exception();
+            }
+        }
+    }
+
+    // Applies single call, exception is left to the caller
+    void Execute(operation &op) {
+        switch (op.type) {
+        case operation::Put:
+            op.result = SimpleLRU::Put(op.key, *op.value);
+            break;
+        case operation::PutIfAbsent:
+            op.result = SimpleLRU::PutIfAbsent(op.key, *op.value);
+            break;
+        case operation::Set:
+            op.result = SimpleLRU::Set(op.key, *op.value);
+            break;
+        case operation::Delete:
+            op.result = SimpleLRU::Delete(op.key);
+            break;
+        case operation::Get:
+            op.result = SimpleLRU::Get(op.key, *op.out);
+            break;
+        case operation::GetView:
+            op.result = SimpleLRU::GetView(op.key, *op.view);
+            break;
+        }
+    }
+
+    Concurrency::FlatCombine<operation> _combine;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FLAT_COMBINE_LRU_H
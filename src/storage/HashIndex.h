@@ -0,0 +1,137 @@
+#ifndef AFINA_STORAGE_HASH_INDEX_H
+#define AFINA_STORAGE_HASH_INDEX_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Open addressing index
+ * Maps keys onto nodes owned by somebody else. Each slot keeps full hash of the key next to the node pointer, so
+ * probing doesn't touch node memory until hashes are equal. Collisions are resolved by linear probing, removal
+ * uses backward shift, so there are no tombstones and lookups don't degrade after days of churn.
+ *
+ * Node type must provide:
+ * - std::size_t hash: hash of the key as returned by HashIndex::Hash
+ * - bool KeyEquals(const std::string &key) const
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+template <typename Node> class HashIndex {
+public:
+    HashIndex(std::size_t capacity = 16) : _size(0) { Reset(capacity); }
+
+    static std::size_t Hash(const std::string &key) { return std::hash<std::string>()(key); }
+
+    /**
+     * Returns node associated with the given key or nullptr if there is no such
+     */
+    Node *Find(const std::string &key, std::size_t hash) const {
+        for (std::size_t i = hash & _mask;; i = (i + 1) & _mask) {
+            const slot &s = _slots[i];
+            if (s.node == nullptr) {
+                return nullptr;
+            }
+            if (s.hash == hash && s.node->KeyEquals(key)) {
+                return s.node;
+            }
+        }
+    }
+
+    /**
+     * Adds node into index, caller must ensure that there is no other node with the same key
+     */
+    void Insert(Node *node) {
+        if ((_size + 1) * 4 > _slots.size() * 3) {
+            Rehash(_slots.size() * 2);
+        }
+        Place(node);
+        _size++;
+    }
+
+    /**
+     * Removes given node from index, it is no-op if node isn't there
+     */
+    void Erase(Node *node) {
+        std::size_t i = node->hash & _mask;
+        for (; _slots[i].node != node; i = (i + 1) & _mask) {
+            if (_slots[i].node == nullptr) {
+                return;
+            }
+        }
+
+        // Backward shift: pull up every following node of the same cluster that would be unreachable once slot i
+        // gets empty, i.e whose home position isn't cyclically in (i, j]
+        for (std::size_t j = (i + 1) & _mask; _slots[j].node != nullptr; j = (j + 1) & _mask) {
+            std::size_t home = _slots[j].hash & _mask;
+            bool reachable = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (!reachable) {
+                _slots[i] = _slots[j];
+                i = j;
+            }
+        }
+        _slots[i].node = nullptr;
+        _size--;
+    }
+
+    inline std::size_t Size() const { return _size; }
+
+    /**
+     * Forget all nodes, nodes itself are untouched
+     */
+    void Clear() {
+        Reset(16);
+        _size = 0;
+    }
+
+private:
+    struct slot {
+        std::size_t hash;
+        Node *node;
+    };
+
+    void Reset(std::size_t capacity) {
+        std::size_t n = 16;
+        while (n < capacity) {
+            n <<= 1;
+        }
+        _slots.assign(n, slot{0, nullptr});
+        _mask = n - 1;
+    }
+
+    void Place(Node *node) {
+        std::size_t i = node->hash & _mask;
+        while (_slots[i].node != nullptr) {
+            i = (i + 1) & _mask;
+        }
+        _slots[i].hash = node->hash;
+        _slots[i].node = node;
+    }
+
+    void Rehash(std::size_t capacity) {
+        std::vector<slot> old;
+        old.swap(_slots);
+        Reset(capacity);
+        for (auto &s : old) {
+            if (s.node != nullptr) {
+                Place(s.node);
+            }
+        }
+    }
+
+    // Number of nodes in the index
+    std::size_t _size;
+
+    // Slots table, size is always power of 2 and table is never filled more then on 3/4
+    std::vector<slot> _slots;
+    std::size_t _mask;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_INDEX_H
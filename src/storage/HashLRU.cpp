@@ -0,0 +1,161 @@
+#include "HashLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+// See HashLRU.h
+HashLRU::~HashLRU() {
+    // Iterative cleanup, list could be millions of nodes long
+    while (_lru_head != nullptr) {
+        lru_node *next = _lru_head->next;
+        delete _lru_head;
+        _lru_head = next;
+    }
+    _lru_tail = nullptr;
+}
+
+// See HashLRU.h
+bool HashLRU::Put(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    std::size_t hash = _lru_index.Hash(key);
+    lru_node *node = _lru_index.Find(key, hash);
+    if (node == nullptr) {
+        return PutNew(key, value, hash);
+    }
+    return PutOld(node, value);
+}
+
+// See HashLRU.h
+bool HashLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    std::size_t hash = _lru_index.Hash(key);
+    if (_lru_index.Find(key, hash) != nullptr) {
+        return false;
+    }
+    return PutNew(key, value, hash);
+}
+
+// See HashLRU.h
+bool HashLRU::Set(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    lru_node *node = _lru_index.Find(key, _lru_index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+    return PutOld(node, value);
+}
+
+// See HashLRU.h
+bool HashLRU::Delete(const std::string &key) {
+    lru_node *node = _lru_index.Find(key, _lru_index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+
+    Remove(node);
+    return true;
+}
+
+// See HashLRU.h
+bool HashLRU::Get(const std::string &key, std::string &value) {
+    lru_node *node = _lru_index.Find(key, _lru_index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+
+    value = *node->value;
+    MoveToTail(node);
+    return true;
+}
+
+// See HashLRU.h
+bool HashLRU::GetView(const std::string &key, std::shared_ptr<const std::string> &value) {
+    lru_node *node = _lru_index.Find(key, _lru_index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+
+    value = node->value;
+    MoveToTail(node);
+    return true;
+}
+
+bool HashLRU::PutOld(lru_node *node, const std::string &value) {
+    // Make node the freshest first, so it won't be evicted to free space for itself
+    MoveToTail(node);
+    while (_current_size - node->value->size() + value.size() > _max_size) {
+        Remove(_lru_head);
+    }
+
+    _current_size = _current_size - node->value->size() + value.size();
+    node->value = std::make_shared<const std::string>(value);
+    return true;
+}
+
+bool HashLRU::PutNew(const std::string &key, const std::string &value, std::size_t hash) {
+    const std::size_t insert_memory = key.size() + value.size();
+    while (_max_size - _current_size < insert_memory) {
+        Remove(_lru_head);
+    }
+
+    lru_node *node = new lru_node(key, value, hash);
+    node->prev = _lru_tail;
+    if (_lru_tail != nullptr) {
+        _lru_tail->next = node;
+    } else {
+        _lru_head = node;
+    }
+    _lru_tail = node;
+
+    _lru_index.Insert(node);
+    _current_size += insert_memory;
+    return true;
+}
+
+void HashLRU::MoveToTail(lru_node *node) {
+    if (node == _lru_tail) {
+        return;
+    }
+
+    // Unlink, node isn't tail so next always exists
+    node->next->prev = node->prev;
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        _lru_head = node->next;
+    }
+
+    node->prev = _lru_tail;
+    node->next = nullptr;
+    _lru_tail->next = node;
+    _lru_tail = node;
+}
+
+void HashLRU::Remove(lru_node *node) {
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    } else {
+        _lru_tail = node->prev;
+    }
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        _lru_head = node->next;
+    }
+
+    _lru_index.Erase(node);
+    _current_size -= node->key.size() + node->value->size();
+    delete node;
+}
+
+} // namespace Backend
+} // namespace Afina
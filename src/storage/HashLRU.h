@@ -0,0 +1,97 @@
+#ifndef AFINA_STORAGE_HASH_LRU_H
+#define AFINA_STORAGE_HASH_LRU_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "HashIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Hash based implementation
+ * Nodes are linked into intrusive double-linked list by raw pointers and indexed by open addressing hash
+ * table, so Get/Put are O(1) and there is no reference counting on the hot path.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class HashLRU : public Afina::Storage {
+public:
+    HashLRU(size_t max_size = 1024) : _max_size(max_size), _current_size(0), _lru_head(nullptr), _lru_tail(nullptr) {}
+
+    ~HashLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetView(const std::string &key, std::shared_ptr<const std::string> &value) override;
+
+protected:
+    // LRU cache node
+    struct lru_node {
+        const std::string key;
+        // Shared with readers got it by GetView, so it is replaced rather then changed in place
+        std::shared_ptr<const std::string> value;
+        const std::size_t hash;
+
+        lru_node *prev;
+        lru_node *next;
+
+        // Node is waiting for deferred move to the tail, see ReadMostlyLRU
+        std::atomic<bool> pending;
+
+        lru_node(const std::string &key, const std::string &value, std::size_t hash)
+            : key(key), value(std::make_shared<const std::string>(value)), hash(hash), prev(nullptr), next(nullptr), pending(false) {}
+
+        inline bool KeyEquals(const std::string &other) const { return key == other; }
+    };
+
+    // Updates value of existing node and makes it the freshest one
+    bool PutOld(lru_node *node, const std::string &value);
+
+    // Creates new node, evicts old ones if there is no space left
+    bool PutNew(const std::string &key, const std::string &value, std::size_t hash);
+
+    // Move node to the tail of the list
+    void MoveToTail(lru_node *node);
+
+    // Unlink node from the list and index, then destroy it
+    void Remove(lru_node *node);
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    const std::size_t _max_size;
+    std::size_t _current_size;
+
+    // Main storage of lru_nodes, elements in this list ordered descending by "freshness": in the head
+    // element that wasn't used for longest time.
+    //
+    // List owns all nodes
+    lru_node *_lru_head;
+    lru_node *_lru_tail;
+
+    // Index of nodes from list above, allows fast random access to elements by lru_node#key
+    HashIndex<lru_node> _lru_index;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_LRU_H
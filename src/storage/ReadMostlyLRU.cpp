@@ -0,0 +1,113 @@
+#include "ReadMostlyLRU.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace Afina {
+namespace Backend {
+
+constexpr std::size_t ReadMostlyLRU::stripes_count;
+constexpr std::size_t ReadMostlyLRU::stripe_size;
+
+// See ReadMostlyLRU.h
+ReadMostlyLRU::ReadMostlyLRU(size_t max_size) : HashLRU(max_size) {
+    for (auto &s : _stripes) {
+        s.size.store(0, std::memory_order_relaxed);
+    }
+}
+
+// See ReadMostlyLRU.h
+bool ReadMostlyLRU::Put(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    Drain();
+    return HashLRU::Put(key, value);
+}
+
+// See ReadMostlyLRU.h
+bool ReadMostlyLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    Drain();
+    return HashLRU::PutIfAbsent(key, value);
+}
+
+// See ReadMostlyLRU.h
+bool ReadMostlyLRU::Set(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    Drain();
+    return HashLRU::Set(key, value);
+}
+
+// See ReadMostlyLRU.h
+bool ReadMostlyLRU::Delete(const std::string &key) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    // Buffers must not keep pointer to the deleted node
+    Drain();
+    return HashLRU::Delete(key);
+}
+
+// See ReadMostlyLRU.h
+bool ReadMostlyLRU::Get(const std::string &key, std::string &value) {
+    // Value is copied out of the lock
+    std::shared_ptr<const std::string> view;
+    if (!GetView(key, view)) {
+        return false;
+    }
+
+    value = *view;
+    return true;
+}
+
+// See ReadMostlyLRU.h
+bool ReadMostlyLRU::GetView(const std::string &key, std::shared_ptr<const std::string> &value) {
+    bool recorded = true;
+    {
+        Concurrency::SharedLock<Concurrency::SharedMutex> lock(_mutex);
+        lru_node *node = _lru_index.Find(key, _lru_index.Hash(key));
+        if (node == nullptr) {
+            return false;
+        }
+
+        value = node->value;
+        recorded = Enqueue(node);
+    }
+
+    // Buffer is full, help writers to apply hits but never wait for the lock on the read path
+    if (!recorded && _mutex.try_lock()) {
+        Drain();
+        _mutex.unlock();
+    }
+    return true;
+}
+
+bool ReadMostlyLRU::Enqueue(lru_node *node) {
+    // Node is already waiting for promotion, check before write to not bounce cache line of hot node
+    if (node->pending.load(std::memory_order_relaxed) || node->pending.exchange(true, std::memory_order_relaxed)) {
+        return true;
+    }
+
+    stripe &s = _stripes[node->hash % stripes_count];
+    std::size_t pos = s.size.fetch_add(1, std::memory_order_relaxed);
+    if (pos >= stripe_size) {
+        node->pending.store(false, std::memory_order_relaxed);
+        return false;
+    }
+
+    s.nodes[pos].store(node, std::memory_order_relaxed);
+    return true;
+}
+
+void ReadMostlyLRU::Drain() {
+    // Exclusive lock acquisition orders all stores done by readers before this point, so relaxed loads are enough
+    for (auto &s : _stripes) {
+        std::size_t size = std::min(s.size.load(std::memory_order_relaxed), stripe_size);
+        for (std::size_t i = 0; i < size; i++) {
+            lru_node *node = s.nodes[i].load(std::memory_order_relaxed);
+            node->pending.store(false, std::memory_order_relaxed);
+            MoveToTail(node);
+        }
+        s.size.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,70 @@
+#ifndef AFINA_STORAGE_READ_MOSTLY_LRU_H
+#define AFINA_STORAGE_READ_MOSTLY_LRU_H
+
+#include <atomic>
+#include <string>
+
+#include <afina/concurrency/SharedMutex.h>
+
+#include "HashLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # HashLRU for read mostly workloads
+ * Lookups take the lock in shared mode and don't touch the list. Instead hit node is recorded in one of the
+ * promotion buffers, which are drained under exclusive lock: before any modification or by a reader that found
+ * buffer full and managed to grab the lock without waiting.
+ *
+ * Recency is approximate: nodes hit between two drains are moved to the tail in buffer order rather than access
+ * order, and hits are dropped while buffer is full.
+ */
+class ReadMostlyLRU : public HashLRU {
+public:
+    ReadMostlyLRU(size_t max_size = 1024);
+    ~ReadMostlyLRU() {}
+
+    // see HashLRU.h
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // see HashLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // see HashLRU.h
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // see HashLRU.h
+    bool Delete(const std::string &key) override;
+
+    // see HashLRU.h
+    bool Get(const std::string &key, std::string &value) override;
+
+    // see HashLRU.h
+    bool GetView(const std::string &key, std::shared_ptr<const std::string> &value) override;
+
+private:
+    static constexpr std::size_t stripes_count = 16;
+    static constexpr std::size_t stripe_size = 64;
+
+    // Buffer of nodes to be moved to the tail. Readers pick stripe by key hash, so they rarely hit the same
+    // counter. Filled under shared lock, drained under exclusive one
+    struct alignas(64) stripe {
+        std::atomic<std::size_t> size;
+        std::atomic<lru_node *> nodes[stripe_size];
+    };
+
+    // Record hit on the node, returns false if the buffer is full and hit was dropped
+    bool Enqueue(lru_node *node);
+
+    // Apply all recorded hits, requires exclusive lock
+    void Drain();
+
+    Concurrency::SharedMutex _mutex;
+    stripe _stripes[stripes_count];
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_READ_MOSTLY_LRU_H
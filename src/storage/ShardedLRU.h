@@ -0,0 +1,109 @@
+#ifndef AFINA_STORAGE_SHARDED_LRU_H
+#define AFINA_STORAGE_SHARDED_LRU_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Lock striped SimpleLRU
+ * Keys are hashed onto N independent SimpleLRU partitions, each one protected by its own lock, so threads working
+ * with different keys don't serialize on a single mutex.
+ *
+ * Byte budget is split between partitions, so total size of all (keys+values) never exceeds max_size. Note that
+ * eviction order is LRU per partition only, and a single key+value pair must fit into one partition slice. Number
+ * of partitions is cut down so that every slice is at least min_slice bytes, unless the whole budget is smaller.
+ */
+class ShardedLRU : public Afina::Storage {
+public:
+    // Smallest partition worth having, otherwise most of pairs wouldn't fit into any
+    static const size_t min_slice = 4096;
+
+    ShardedLRU(size_t max_size = 1024, size_t shards = 8) {
+        shards = std::min(shards, max_size / min_slice);
+        if (shards == 0) {
+            shards = 1;
+        }
+
+        _shards.reserve(shards);
+        for (size_t i = 0; i < shards; i++) {
+            // Spread reminder over first partitions, so the sum of slices is exactly max_size
+            size_t slice = max_size / shards + (i < max_size % shards ? 1 : 0);
+            _shards.emplace_back(new shard(slice));
+        }
+    }
+    ~ShardedLRU() {}
+
+    /**
+     * Number of partitions actually made
+     */
+    size_t Shards() const { return _shards.size(); }
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value) override {
+        shard &s = Select(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.storage.Put(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        shard &s = Select(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.storage.PutIfAbsent(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value) override {
+        shard &s = Select(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.storage.Set(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key) override {
+        shard &s = Select(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.storage.Delete(key);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value) override {
+        shard &s = Select(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.storage.Get(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool GetView(const std::string &key, std::shared_ptr<const std::string> &value) override {
+        shard &s = Select(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.storage.GetView(key, value);
+    }
+
+private:
+    // Single partition, allocated separately so that locks of different partitions don't share cache line
+    struct shard {
+        shard(size_t max_size) : storage(max_size) {}
+
+        std::mutex mutex;
+        SimpleLRU storage;
+    };
+
+    inline shard &Select(const std::string &key) { return *_shards[std::hash<std::string>()(key) % _shards.size()]; }
+
+    std::vector<std::unique_ptr<shard>> _shards;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SHARDED_LRU_H
@@ -44,8 +44,7 @@ bool SimpleLRU::Delete(const std::string &key) {
     if (delete_element == _lru_index.end())
         return false;
 
-    auto value = delete_element->second.get().value;
-    std::size_t delete_memory = key.size() + value.size();
+    std::size_t delete_memory = key.size() + delete_element->second.get().value->size();
 
     auto next = delete_element->second.get().next;
     auto prev = delete_element->second.get().prev;
@@ -72,6 +71,18 @@ bool SimpleLRU::Get(const std::string &key, std::string &value)  { // const
     if (get_element == _lru_index.end())
         return false;
 
+    value = *get_element->second.get().value;
+    RefreshList(key, get_element);
+
+    return true;
+  }
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::GetView(const std::string &key, std::shared_ptr<const std::string> &value) {
+    auto get_element = _lru_index.find(key);
+    if (get_element == _lru_index.end())
+        return false;
+
     value = get_element->second.get().value;
     RefreshList(key, get_element);
 
@@ -105,11 +116,16 @@ bool SimpleLRU::PutNew(const std::string &key, const std::string & value) {
 
 bool SimpleLRU::PutOld(const std::string &key, const std::string &value,
             my_map::iterator iterator) {
-  auto old_value = iterator->second.get().value;
-  iterator->second.get().value = value;
   RefreshList(key, iterator);
 
-  _current_size += value.size() - old_value.size();
+  // Node is the freshest now, so only others could be evicted to fit the new value
+  lru_node &node = iterator->second.get();
+  while (_current_size - node.value->size() + value.size() > _max_size) {
+      DeleteLast();
+  }
+
+  _current_size = _current_size - node.value->size() + value.size();
+  node.value = std::make_shared<const std::string>(value);
   return true;
 }
 
@@ -141,9 +157,7 @@ bool SimpleLRU::DeleteLast() {
       return false;
 
   auto next = _lru_head->next;
-  auto value = _lru_head->value;
-  auto key = _lru_head->key;
-  std::size_t delete_memory = key.size() + value.size();
+  std::size_t delete_memory = _lru_head->key.size() + _lru_head->value->size();
 
   _lru_index.erase(_lru_head->key);
   if (next == nullptr) {
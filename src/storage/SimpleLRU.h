@@ -27,12 +27,17 @@ public:
     ~SimpleLRU() {
         _lru_index.clear();
 
-        auto ptr = _lru_head;
-        while (ptr->next != nullptr) {
-            ptr = ptr->next;
-            ptr->prev.reset();
+        // Unlink nodes one by one starting from the head, otherwise chain of shared_ptr gets destroyed
+        // recursively and overflows stack on long lists
+        while (_lru_head != nullptr) {
+            auto next = _lru_head->next;
+            _lru_head->next.reset();
+            if (next != nullptr) {
+                next->prev.reset();
+            }
+            _lru_head = next;
         }
-        _lru_tail.reset(); // TODO: Here is stack overflow
+        _lru_tail.reset();
     }
 
     // Implements Afina::Storage interface
@@ -50,17 +55,21 @@ public:
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value)  override; //const
 
+    // Implements Afina::Storage interface
+    bool GetView(const std::string &key, std::shared_ptr<const std::string> &value) override;
+
 private:
     // LRU cache node
     using lru_node = struct lru_node {
         const std::string key;
-        std::string value;
+        // Shared with readers got it by GetView, so it is replaced rather then changed in place
+        std::shared_ptr<const std::string> value;
         // поменял на shared_ptr
         std::shared_ptr<lru_node> prev;
         std::shared_ptr<lru_node> next;
 
         lru_node (const std::string &key, const std::string &value):
-                  key(key), value(value), prev(nullptr), next(nullptr) {}
+                  key(key), value(std::make_shared<const std::string>(value)), prev(nullptr), next(nullptr) {}
     };
 
     // Maximum number of bytes could be stored in this cache.
@@ -0,0 +1,184 @@
+#include "SlabLRU.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <sys/mman.h>
+
+namespace Afina {
+namespace Backend {
+
+static void *MapArena(std::size_t size) {
+    // Pages are reserved only, they get backed by memory once slab allocator cuts chunks out of them
+    void *arena = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (arena == MAP_FAILED) {
+        throw std::runtime_error("Failed to map storage arena");
+    }
+    return arena;
+}
+
+// Slabs are never given back, so arena is split at least into 32 of them to let several classes get memory.
+// Slab size limits entry size as well, so it never drops below a page
+static std::size_t SlabSize(std::size_t arena_size) {
+    return std::min<std::size_t>(1 << 20, std::max<std::size_t>(arena_size / 32, 4096));
+}
+
+// See SlabLRU.h
+SlabLRU::SlabLRU(size_t max_size)
+    : _arena(MapArena(max_size)), _arena_size(max_size), _slab(_arena, max_size, SlabSize(max_size)),
+      _lru(_slab.classes(), lru_list{nullptr, nullptr}) {}
+
+// See SlabLRU.h
+SlabLRU::~SlabLRU() { munmap(_arena, _arena_size); }
+
+// See SlabLRU.h
+bool SlabLRU::Put(const std::string &key, const std::string &value) {
+    std::size_t hash = _index.Hash(key);
+    slab_node *node = _index.Find(key, hash);
+    if (node == nullptr) {
+        return PutNew(key, value, hash);
+    }
+
+    // Value still fits the same class, update in place
+    if (_slab.size_class(NodeSize(key, value)) == node->size_class) {
+        Assign(node, value);
+        return true;
+    }
+
+    // Allocate before removal, so the old value survives if there is no memory for the new one
+    slab_node *fresh = Allocate(NodeSize(key, value));
+    if (fresh == nullptr) {
+        return false;
+    }
+    Remove(node);
+    Fill(fresh, key, value, hash);
+    return true;
+}
+
+// See SlabLRU.h
+bool SlabLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    std::size_t hash = _index.Hash(key);
+    if (_index.Find(key, hash) != nullptr) {
+        return false;
+    }
+    return PutNew(key, value, hash);
+}
+
+// See SlabLRU.h
+bool SlabLRU::Set(const std::string &key, const std::string &value) {
+    std::size_t hash = _index.Hash(key);
+    if (_index.Find(key, hash) == nullptr) {
+        return false;
+    }
+    return Put(key, value);
+}
+
+// See SlabLRU.h
+bool SlabLRU::Delete(const std::string &key) {
+    slab_node *node = _index.Find(key, _index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+
+    Remove(node);
+    return true;
+}
+
+// See SlabLRU.h
+bool SlabLRU::Get(const std::string &key, std::string &value) {
+    slab_node *node = _index.Find(key, _index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+
+    value.assign(node->Value(), node->value_size);
+    Unlink(node);
+    Link(node);
+    return true;
+}
+
+bool SlabLRU::PutNew(const std::string &key, const std::string &value, std::size_t hash) {
+    slab_node *node = Allocate(NodeSize(key, value));
+    if (node == nullptr) {
+        return false;
+    }
+
+    Fill(node, key, value, hash);
+    return true;
+}
+
+SlabLRU::slab_node *SlabLRU::Allocate(std::size_t size) {
+    int size_class = _slab.size_class(size);
+    if (size_class < 0) {
+        return nullptr;
+    }
+
+    void *chunk = _slab.alloc(size);
+    while (chunk == nullptr) {
+        // Chunk of the same class is the only thing that helps
+        slab_node *victim = _lru[size_class].head;
+        if (victim == nullptr) {
+            return nullptr;
+        }
+        Remove(victim);
+        chunk = _slab.alloc(size);
+    }
+
+    slab_node *node = static_cast<slab_node *>(chunk);
+    node->size_class = size_class;
+    return node;
+}
+
+void SlabLRU::Fill(slab_node *node, const std::string &key, const std::string &value, std::size_t hash) {
+    node->hash = hash;
+    node->key_size = key.size();
+    std::memcpy(node->Key(), key.data(), key.size());
+
+    node->value_size = value.size();
+    std::memcpy(node->Value(), value.data(), value.size());
+
+    Link(node);
+    _index.Insert(node);
+}
+
+void SlabLRU::Assign(slab_node *node, const std::string &value) {
+    node->value_size = value.size();
+    std::memcpy(node->Value(), value.data(), value.size());
+    Unlink(node);
+    Link(node);
+}
+
+void SlabLRU::Link(slab_node *node) {
+    lru_list &lru = _lru[node->size_class];
+    node->prev = lru.tail;
+    node->next = nullptr;
+    if (lru.tail != nullptr) {
+        lru.tail->next = node;
+    } else {
+        lru.head = node;
+    }
+    lru.tail = node;
+}
+
+void SlabLRU::Unlink(slab_node *node) {
+    lru_list &lru = _lru[node->size_class];
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    } else {
+        lru.tail = node->prev;
+    }
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        lru.head = node->next;
+    }
+}
+
+void SlabLRU::Remove(slab_node *node) {
+    Unlink(node);
+    _index.Erase(node);
+    _slab.free(node);
+}
+
+} // namespace Backend
+} // namespace Afina
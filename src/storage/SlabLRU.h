@@ -0,0 +1,110 @@
+#ifndef AFINA_STORAGE_SLAB_LRU_H
+#define AFINA_STORAGE_SLAB_LRU_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Slab.h>
+
+#include "HashIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU on top of slab allocator
+ * Whole entry, i.e node header, key and value, lives in one chunk of Allocator::Slab over an arena mmap'ed at
+ * construction, so max_size bounds real memory used by entries and churn doesn't fragment heap.
+ *
+ * Each size class has its own LRU list, memory for a new entry is freed by evicting the eldest entries of the same
+ * class, like memcached does. Slabs are never moved between classes, so once arena is fully given away an entry
+ * of a class that got no slabs can't be stored.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class SlabLRU : public Afina::Storage {
+public:
+    SlabLRU(size_t max_size = 1024);
+    ~SlabLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    /**
+     * Allocator usage, see Allocator::Slab::dump
+     */
+    std::string Dump() const { return _slab.dump(); }
+
+private:
+    // Header of the chunk, key and value bytes follow it
+    struct slab_node {
+        slab_node *prev;
+        slab_node *next;
+        std::size_t hash;
+        uint32_t key_size;
+        uint32_t value_size;
+        int size_class;
+
+        inline char *Key() { return reinterpret_cast<char *>(this + 1); }
+        inline char *Value() { return Key() + key_size; }
+
+        inline bool KeyEquals(const std::string &other) const {
+            return key_size == other.size() && std::memcmp(this + 1, other.data(), key_size) == 0;
+        }
+    };
+
+    struct lru_list {
+        slab_node *head;
+        slab_node *tail;
+    };
+
+    static inline std::size_t NodeSize(const std::string &key, const std::string &value) {
+        return sizeof(slab_node) + key.size() + value.size();
+    }
+
+    bool PutNew(const std::string &key, const std::string &value, std::size_t hash);
+
+    // Returns chunk for node of the given size, evicting the eldest entries of its class if necessary
+    slab_node *Allocate(std::size_t size);
+
+    // Initialize node in the allocated chunk, link it into LRU list and index
+    void Fill(slab_node *node, const std::string &key, const std::string &value, std::size_t hash);
+
+    // Copy value into node that has enough space for it
+    void Assign(slab_node *node, const std::string &value);
+
+    void Link(slab_node *node);
+    void Unlink(slab_node *node);
+    void Remove(slab_node *node);
+
+    // Arena all entries live in
+    void *_arena;
+    std::size_t _arena_size;
+
+    Allocator::Slab _slab;
+
+    // LRU list per size class, head is the eldest element
+    std::vector<lru_list> _lru;
+
+    HashIndex<slab_node> _index;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SLAB_LRU_H
@@ -55,6 +55,12 @@ public:
         return SimpleLRU::Get(key, value);
     }
 
+    // see SimpleLRU.h
+    bool GetView(const std::string &key, std::shared_ptr<const std::string> &value) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return SimpleLRU::GetView(key, value);
+    }
+
 private:
     // TODO: sinchronization primitives
     std::mutex _mutex;
@@ -0,0 +1,314 @@
+#include "TinyLFU.h"
+
+#include <algorithm>
+
+namespace Afina {
+namespace Backend {
+
+// See TinyLFU.h
+TinyLFU::TinyLFU(size_t max_size)
+    : _max_size(max_size), _window_max(std::max<size_t>(1, max_size / 100)),
+      _protected_max((max_size - _window_max) * 8 / 10), _current_size(0) {}
+
+// See TinyLFU.h
+TinyLFU::~TinyLFU() {
+    for (auto q : {&_window, &_probation, &_protected}) {
+        while (q->head != nullptr) {
+            lfu_node *next = q->head->next;
+            delete q->head;
+            q->head = next;
+        }
+    }
+}
+
+// See TinyLFU.h
+bool TinyLFU::Put(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t hash = _index.Hash(key);
+    _sketch.Increment(hash);
+
+    lfu_node *node = _index.Find(key, hash);
+    if (node == nullptr) {
+        return PutNew(key, value, hash);
+    }
+    return PutOld(node, value);
+}
+
+// See TinyLFU.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t hash = _index.Hash(key);
+    _sketch.Increment(hash);
+
+    if (_index.Find(key, hash) != nullptr) {
+        return false;
+    }
+    return PutNew(key, value, hash);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Set(const std::string &key, const std::string &value) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t hash = _index.Hash(key);
+    _sketch.Increment(hash);
+
+    lfu_node *node = _index.Find(key, hash);
+    if (node == nullptr) {
+        return false;
+    }
+    return PutOld(node, value);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Delete(const std::string &key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    lfu_node *node = _index.Find(key, _index.Hash(key));
+    if (node == nullptr) {
+        return false;
+    }
+
+    Remove(node);
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::string &value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t hash = _index.Hash(key);
+
+    // Misses are counted as well, otherwise nobody from outside could ever win admission
+    _sketch.Increment(hash);
+
+    lfu_node *node = _index.Find(key, hash);
+    if (node == nullptr) {
+        return false;
+    }
+
+    value = node->value;
+    OnHit(node);
+    Maintain(node);
+    return true;
+}
+
+bool TinyLFU::PutOld(lfu_node *node, const std::string &value) {
+    _current_size = _current_size - node->value.size() + value.size();
+
+    // Segment size depends on node size, so node leaves queue for the update
+    Segment segment = node->segment;
+    Unlink(node);
+    node->value = value;
+    Link(node, segment);
+
+    OnHit(node);
+    Maintain(node);
+    return true;
+}
+
+bool TinyLFU::PutNew(const std::string &key, const std::string &value, std::size_t hash) {
+    if (_index.Size() >= _sketch.Width()) {
+        _sketch.Resize(2 * _index.Size());
+    }
+
+    lfu_node *node = new lfu_node(key, value, hash);
+    _index.Insert(node);
+    Link(node, Segment::Window);
+    _current_size += node->Size();
+
+    Maintain(node);
+    return true;
+}
+
+void TinyLFU::OnHit(lfu_node *node) {
+    // Window is plain LRU, hit in main space makes entry protected
+    Segment target = (node->segment == Segment::Window) ? Segment::Window : Segment::Protected;
+    Unlink(node);
+    Link(node, target);
+}
+
+void TinyLFU::Maintain(lfu_node *keep) {
+    // Eldest protected entries get a second chance in probation
+    while (_protected.size > _protected_max) {
+        lfu_node *node = _protected.head;
+        Unlink(node);
+        Link(node, Segment::Probation);
+    }
+
+    // Entries pushed out of window become admission candidates in the fresh end of probation
+    while (_window.size > _window_max && _window.head != keep) {
+        lfu_node *node = _window.head;
+        Unlink(node);
+        Link(node, Segment::Probation);
+    }
+
+    while (_current_size > _max_size) {
+        // Candidate from the fresh end of probation competes with the eldest one, less frequent entry goes away
+        lfu_node *victim = _probation.head;
+        lfu_node *candidate = _probation.tail;
+        if (victim == keep) {
+            victim = victim->next;
+        }
+        if (candidate == keep) {
+            candidate = candidate->prev;
+        }
+
+        lfu_node *evict = nullptr;
+        if (victim != nullptr && candidate != nullptr && victim != candidate) {
+            if (_sketch.Frequency(candidate->hash) > _sketch.Frequency(victim->hash)) {
+                evict = victim;
+            } else {
+                evict = candidate;
+            }
+        } else if (victim != nullptr) {
+            evict = victim;
+        } else if (_protected.head != nullptr) {
+            lfu_node *node = _protected.head;
+            Unlink(node);
+            Link(node, Segment::Probation);
+            continue;
+        } else {
+            evict = (_window.head == keep) ? keep->next : _window.head;
+        }
+
+        if (evict == nullptr) {
+            break;
+        }
+        Remove(evict);
+    }
+}
+
+TinyLFU::lfu_queue &TinyLFU::Queue(Segment segment) {
+    switch (segment) {
+    case Segment::Window:
+        return _window;
+    case Segment::Probation:
+        return _probation;
+    default:
+        return _protected;
+    }
+}
+
+void TinyLFU::Link(lfu_node *node, Segment segment) {
+    lfu_queue &q = Queue(segment);
+    node->segment = segment;
+    node->prev = q.tail;
+    node->next = nullptr;
+    if (q.tail != nullptr) {
+        q.tail->next = node;
+    } else {
+        q.head = node;
+    }
+    q.tail = node;
+    q.size += node->Size();
+}
+
+void TinyLFU::Unlink(lfu_node *node) {
+    lfu_queue &q = Queue(node->segment);
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    } else {
+        q.tail = node->prev;
+    }
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        q.head = node->next;
+    }
+    node->prev = node->next = nullptr;
+    q.size -= node->Size();
+}
+
+void TinyLFU::Remove(lfu_node *node) {
+    Unlink(node);
+    _index.Erase(node);
+    _current_size -= node->Size();
+    delete node;
+}
+
+void TinyLFU::FrequencySketch::Resize(std::size_t entries) {
+    std::size_t width = std::max<std::size_t>(_width, 1024);
+    int shift = 64;
+    for (std::size_t w = 1; w < width; w <<= 1) {
+        shift--;
+    }
+    while (width < entries) {
+        width <<= 1;
+        shift--;
+    }
+    if (width == _width) {
+        return;
+    }
+
+    // Index is the top bits of hash product, so counter i of narrow row covers counters [i * factor, (i + 1) *
+    // factor) of the wide one
+    std::vector<uint8_t> old;
+    old.swap(_table);
+    std::size_t old_width = _width;
+    _table.assign(4 * width / 2, 0);
+    _width = width;
+    _shift = shift;
+    if (old_width == 0) {
+        return;
+    }
+
+    std::size_t factor = width / old_width;
+    for (std::size_t row = 0; row < 4; row++) {
+        for (std::size_t i = 0; i < old_width; i++) {
+            std::size_t from = row * old_width + i;
+            uint8_t value = (old[from >> 1] >> ((from & 1) << 2)) & 0x0F;
+            if (value == 0) {
+                continue;
+            }
+            for (std::size_t k = 0; k < factor; k++) {
+                SetCounter(row * width + i * factor + k, value);
+            }
+        }
+    }
+}
+
+std::size_t TinyLFU::FrequencySketch::Index(std::size_t hash, int row) const {
+    // Multiply-shift hashing, independent odd multiplier per row
+    static const uint64_t seeds[] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+                                     0xD6E8FEB86659FD93ULL};
+    return row * _width + ((uint64_t(hash) * seeds[row]) >> _shift);
+}
+
+void TinyLFU::FrequencySketch::Increment(std::size_t hash) {
+    for (int row = 0; row < 4; row++) {
+        std::size_t i = Index(hash, row);
+        uint8_t counter = Counter(i);
+        if (counter < 15) {
+            SetCounter(i, counter + 1);
+        }
+    }
+
+    // Aging: halve all counters once per sample period, both halves of a byte at once
+    if (++_samples >= 10 * _width) {
+        for (auto &pair : _table) {
+            pair = (pair >> 1) & 0x77;
+        }
+        _samples /= 2;
+    }
+}
+
+uint8_t TinyLFU::FrequencySketch::Frequency(std::size_t hash) const {
+    uint8_t result = 15;
+    for (int row = 0; row < 4; row++) {
+        result = std::min(result, Counter(Index(hash, row)));
+    }
+    return result;
+}
+
+} // namespace Backend
+} // namespace Afina
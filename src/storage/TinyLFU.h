@@ -0,0 +1,139 @@
+#ifndef AFINA_STORAGE_TINY_LFU_H
+#define AFINA_STORAGE_TINY_LFU_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "HashIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # W-TinyLFU cache
+ * Scan resistant policy: new entries land in a small LRU window (1% of budget), entries pushed out of the window
+ * must win admission into main space against its eldest entry. Winner is the one with higher access frequency,
+ * which is estimated by count-min sketch over all recent accesses, hits and misses. Main space is segmented LRU:
+ * entries hit while in probation segment are promoted to protected one (80% of main space).
+ *
+ * One-hit wonders of a full scan never beat frequently used entries, so they flow through the window and leave
+ * the hot set intact.
+ *
+ * Thread safe, all operations are under single lock as even Get updates sketch and queues
+ */
+class TinyLFU : public Afina::Storage {
+public:
+    TinyLFU(size_t max_size = 1024);
+    ~TinyLFU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+private:
+    enum class Segment : uint8_t { Window, Probation, Protected };
+
+    struct lfu_node {
+        const std::string key;
+        std::string value;
+        const std::size_t hash;
+
+        lfu_node *prev;
+        lfu_node *next;
+        Segment segment;
+
+        lfu_node(const std::string &key, const std::string &value, std::size_t hash)
+            : key(key), value(value), hash(hash), prev(nullptr), next(nullptr), segment(Segment::Window) {}
+
+        inline bool KeyEquals(const std::string &other) const { return key == other; }
+        inline std::size_t Size() const { return key.size() + value.size(); }
+    };
+
+    // LRU list of one segment, head is the eldest element
+    struct lfu_queue {
+        lfu_node *head = nullptr;
+        lfu_node *tail = nullptr;
+        std::size_t size = 0;
+    };
+
+    /**
+     * Count-min sketch of 4 rows with 4-bit saturating counters, two of them packed in a byte. Once number of
+     * recorded accesses reaches 10 x width all counters are halved, so the history fades out
+     */
+    class FrequencySketch {
+    public:
+        FrequencySketch() : _width(0), _shift(64), _samples(0) { Resize(0); }
+
+        // Widen table to fit given number of entries. Every counter is copied into the ones its keys map to in
+        // the wider table, so estimates stay the same and history isn't lost while cache warms up
+        void Resize(std::size_t entries);
+        inline std::size_t Width() const { return _width; }
+
+        void Increment(std::size_t hash);
+        uint8_t Frequency(std::size_t hash) const;
+
+    private:
+        inline std::size_t Index(std::size_t hash, int row) const;
+
+        inline uint8_t Counter(std::size_t i) const { return (_table[i >> 1] >> ((i & 1) << 2)) & 0x0F; }
+        inline void SetCounter(std::size_t i, uint8_t value) {
+            int shift = (i & 1) << 2;
+            _table[i >> 1] = (_table[i >> 1] & ~(0x0F << shift)) | (value << shift);
+        }
+
+        // 4 rows of width counters each
+        std::vector<uint8_t> _table;
+        std::size_t _width;
+        int _shift;
+        std::size_t _samples;
+    };
+
+    bool PutOld(lfu_node *node, const std::string &value);
+    bool PutNew(const std::string &key, const std::string &value, std::size_t hash);
+
+    // Reposition node on hit
+    void OnHit(lfu_node *node);
+
+    // Restore segments limits and evict entries until total size fits into budget. Given node is never evicted
+    void Maintain(lfu_node *keep);
+
+    lfu_queue &Queue(Segment segment);
+    void Link(lfu_node *node, Segment segment);
+    void Unlink(lfu_node *node);
+    void Remove(lfu_node *node);
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    const std::size_t _max_size;
+    const std::size_t _window_max;
+    const std::size_t _protected_max;
+    std::size_t _current_size;
+
+    lfu_queue _window;
+    lfu_queue _probation;
+    lfu_queue _protected;
+
+    FrequencySketch _sketch;
+    HashIndex<lfu_node> _index;
+    std::mutex _mutex;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TINY_LFU_H
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <afina/allocator/Adapter.h>
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+
+static char area[1 << 20];
+
+TEST(AdapterTest, Vector) {
+    Simple a(area, sizeof(area));
+
+    vector<int, Adapter<int>> v{Adapter<int>(a)};
+    for (int i = 0; i < 10000; i++) {
+        v.push_back(i);
+    }
+    for (int i = 0; i < 10000; i++) {
+        EXPECT_EQ(v[i], i);
+    }
+}
+
+TEST(AdapterTest, UnorderedMap) {
+    Simple a(area, sizeof(area));
+
+    typedef Adapter<pair<const int, int>> alloc_t;
+    unordered_map<int, int, hash<int>, equal_to<int>, alloc_t> m(16, hash<int>(), equal_to<int>(), alloc_t(a));
+    for (int i = 0; i < 5000; i++) {
+        m[i] = i * 2;
+    }
+    for (int i = 0; i < 5000; i += 2) {
+        m.erase(i);
+    }
+    for (int i = 0; i < 5000; i++) {
+        if (i % 2 == 0) {
+            EXPECT_EQ(m.count(i), 0);
+        } else {
+            EXPECT_EQ(m.at(i), i * 2);
+        }
+    }
+}
+
+TEST(AdapterTest, NoMemory) {
+    Simple a(area, 4096);
+
+    vector<char, Adapter<char>> v{Adapter<char>(a)};
+    EXPECT_THROW(v.resize(8192), bad_alloc);
+}
+
+TEST(AdapterTest, PinnedSurviveDefrag) {
+    Simple a(area, sizeof(area));
+
+    // Movable and pinned blocks interleaved, defrag has to move the former around the latter
+    vector<Pointer> movable;
+    list<string, Adapter<string>> pinned{Adapter<string>(a)};
+    for (int i = 0; i < 100; i++) {
+        movable.push_back(a.alloc(100));
+        memset(movable.back().get(), i, 100);
+        pinned.push_back(to_string(i));
+    }
+    for (size_t i = 0; i < movable.size(); i += 2) {
+        a.free(movable[i]);
+    }
+
+    a.defrag();
+
+    int i = 0;
+    for (auto &s : pinned) {
+        EXPECT_EQ(s, to_string(i++));
+    }
+    for (size_t i = 1; i < movable.size(); i += 2) {
+        char *p = static_cast<char *>(movable[i].get());
+        EXPECT_EQ(p[0], char(i));
+        EXPECT_EQ(p[99], char(i));
+    }
+}
+
+TEST(AdapterTest, InvalidFree) {
+    Simple a(area, sizeof(area));
+
+    Pointer p = a.alloc(100);
+    try {
+        a.free_pinned(p.get());
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::InvalidFree);
+    }
+}
@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/Concurrent.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+
+static void fill(void *p, size_t size, char tag) { memset(p, tag, size); }
+
+static bool check(void *p, size_t size, char tag) {
+    char *v = reinterpret_cast<char *>(p);
+    for (size_t i = 0; i < size; i++) {
+        if (v[i] != tag) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(ConcurrentTest, AllocReadWrite) {
+    Concurrent a(1 << 22);
+
+    vector<pair<void *, size_t>> ptrs;
+    for (size_t size = 1; size <= 2 * a.max_size(); size += 37) {
+        void *p = a.alloc(size);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(max_align_t), 0);
+        fill(p, size, char(size));
+        ptrs.emplace_back(p, size);
+    }
+
+    for (auto &p : ptrs) {
+        EXPECT_TRUE(check(p.first, p.second, char(p.second)));
+        a.free(p.first);
+    }
+}
+
+TEST(ConcurrentTest, ReuseFreed) {
+    Concurrent a(1 << 20);
+
+    void *p = a.alloc(100);
+    a.free(p);
+    EXPECT_EQ(a.alloc(100), p);
+}
+
+TEST(ConcurrentTest, ArenaExhausted) {
+    Concurrent a(1 << 16, 1 << 12);
+
+    // Once slabs are over allocator falls back to malloc
+    vector<void *> ptrs;
+    for (int i = 0; i < 1000; i++) {
+        ptrs.push_back(a.alloc(64));
+        ASSERT_NE(ptrs.back(), nullptr);
+        fill(ptrs.back(), 64, char(i));
+    }
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(check(ptrs[i], 64, char(i)));
+        a.free(ptrs[i]);
+    }
+}
+
+TEST(ConcurrentTest, RemoteFree) {
+    Concurrent a(1 << 24);
+    const int count = 100000;
+
+    // Producer allocates, consumer frees, so every free is remote one
+    vector<atomic<void *>> slots(1024);
+    for (auto &s : slots) {
+        s.store(nullptr);
+    }
+
+    thread producer([&]() {
+        for (int i = 0; i < count; i++) {
+            void *p = a.alloc(48);
+            fill(p, 48, char(i));
+            auto &slot = slots[i % slots.size()];
+            void *expected = nullptr;
+            while (!slot.compare_exchange_weak(expected, p)) {
+                expected = nullptr;
+                this_thread::yield();
+            }
+        }
+    });
+
+    int freed = 0;
+    while (freed < count) {
+        for (auto &s : slots) {
+            void *p = s.exchange(nullptr);
+            if (p != nullptr) {
+                a.free(p);
+                freed++;
+            }
+        }
+    }
+    producer.join();
+
+    // Everything freed remotely is reused by the next thread that gets producer's state
+    thread next([&]() {
+        for (int i = 0; i < count; i++) {
+            a.free(a.alloc(48));
+        }
+    });
+    next.join();
+}
+
+TEST(ConcurrentTest, ManyThreads) {
+    Concurrent a(1 << 24);
+
+    vector<thread> workers;
+    atomic<bool> ok(true);
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&a, &ok, t]() {
+            vector<pair<void *, size_t>> ptrs;
+            for (int i = 0; i < 20000; i++) {
+                size_t size = 16 + (i * 7919 + t) % 1000;
+                void *p = a.alloc(size);
+                fill(p, size, char(t));
+                ptrs.emplace_back(p, size);
+                if (ptrs.size() > 100) {
+                    auto &old = ptrs[i % ptrs.size()];
+                    ok = ok && check(old.first, old.second, char(t));
+                    a.free(old.first);
+                    old = ptrs.back();
+                    ptrs.pop_back();
+                }
+            }
+            for (auto &p : ptrs) {
+                ok = ok && check(p.first, p.second, char(t));
+                a.free(p.first);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    EXPECT_TRUE(ok);
+}
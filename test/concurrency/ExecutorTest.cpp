@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+// Tasks block on it until test lets them go
+class Gate {
+public:
+    void Enter() {
+        unique_lock<mutex> lock(_lock);
+        _entered++;
+        _cv.notify_all();
+        _cv.wait(lock, [this]() { return _open; });
+    }
+
+    bool AwaitEntered(int n) {
+        unique_lock<mutex> lock(_lock);
+        return _cv.wait_for(lock, chrono::seconds(5), [this, n]() { return _entered >= n; });
+    }
+
+    void Open() {
+        unique_lock<mutex> lock(_lock);
+        _open = true;
+        _cv.notify_all();
+    }
+
+private:
+    mutex _lock;
+    condition_variable _cv;
+    int _entered = 0;
+    bool _open = false;
+};
+
+TEST(ExecutorTest, CompletesTasks) {
+    Executor executor("test", 1, 4, 64, 100);
+    executor.Start();
+
+    atomic<int> done(0);
+    for (int i = 0; i < 50; i++) {
+        ASSERT_TRUE(executor.Execute([&done](int n) { done += n; }, 1));
+    }
+
+    // Queued tasks are completed on stop, new ones are refused
+    executor.Stop(true);
+    EXPECT_EQ(50, done.load());
+    EXPECT_FALSE(executor.Execute([&done]() { done++; }));
+}
+
+TEST(ExecutorTest, GrowsToHighWatermark) {
+    Executor executor("test", 1, 3, 64, 100);
+    executor.Start();
+
+    Gate gate;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(executor.Execute([&gate]() { gate.Enter(); }));
+    }
+    EXPECT_TRUE(gate.AwaitEntered(3));
+
+    gate.Open();
+    executor.Stop(true);
+}
+
+TEST(ExecutorTest, QueuesUpToLimit) {
+    Executor executor("test", 1, 1, 2, 100);
+    executor.Start();
+
+    Gate gate;
+    ASSERT_TRUE(executor.Execute([&gate]() { gate.Enter(); }));
+    ASSERT_TRUE(gate.AwaitEntered(1));
+
+    // The only thread is busy, tasks wait in the queue until it is full
+    atomic<int> done(0);
+    EXPECT_TRUE(executor.Execute([&done]() { done++; }));
+    EXPECT_TRUE(executor.Execute([&done]() { done++; }));
+    EXPECT_FALSE(executor.Execute([&done]() { done++; }));
+
+    gate.Open();
+    executor.Stop(true);
+    EXPECT_EQ(2, done.load());
+}
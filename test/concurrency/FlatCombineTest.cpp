@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/FlatCombine.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+struct Add {
+    long delta;
+    long before;
+};
+
+TEST(FlatCombineTest, SingleThread) {
+    long counter = 0;
+    FlatCombine<Add> combine([&counter](Add *const *ops, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            ops[i]->before = counter;
+            counter += ops[i]->delta;
+        }
+    });
+
+    for (long i = 1; i <= 10; i++) {
+        Add op{i, -1};
+        combine.Apply(op);
+        EXPECT_EQ(i * (i - 1) / 2, op.before);
+    }
+    EXPECT_EQ(55, counter);
+    EXPECT_EQ(10, combine.Operations());
+}
+
+TEST(FlatCombineTest, OperationsAreSerialized) {
+    const int threads = 8, per_thread = 20000;
+
+    // Plain counter, only combiner touches it
+    long counter = 0;
+    FlatCombine<Add> combine(
+        [&counter](Add *const *ops, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                ops[i]->before = counter;
+                counter += ops[i]->delta;
+            }
+        },
+        4);
+
+    vector<thread> workers;
+    vector<long> sums(threads, 0);
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&combine, &sums, t, per_thread]() {
+            for (int i = 0; i < per_thread; i++) {
+                Add op{1, -1};
+                combine.Apply(op);
+                sums[t] += op.before;
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    // Each call has seen distinct value, so all of them together are 0 + 1 + ... + (n - 1)
+    long n = long(threads) * per_thread, total = 0;
+    for (long s : sums) {
+        total += s;
+    }
+    EXPECT_EQ(n, counter);
+    EXPECT_EQ(n * (n - 1) / 2, total);
+    EXPECT_EQ(size_t(n), combine.Operations());
+    EXPECT_LE(combine.Batches(), combine.Operations());
+}
+
+TEST(FlatCombineTest, ExecutorThrows) {
+    const int threads = 4, per_thread = 2000;
+
+    long counter = 0;
+    FlatCombine<Add> combine([&counter](Add *const *ops, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            if (ops[i]->delta < 0) {
+                throw std::runtime_error("negative delta");
+            }
+            counter += ops[i]->delta;
+        }
+    });
+
+    Add bad{-1, -1};
+    EXPECT_THROW(combine.Apply(bad), std::runtime_error);
+
+    // Lock is released and slots are freed, so everyone goes on and sees errors of own batches only
+    vector<thread> workers;
+    vector<int> failed(threads, 0);
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&combine, &failed, t, per_thread]() {
+            for (int i = 0; i < per_thread; i++) {
+                Add op{i % 100 == 0 ? -1 : 1, -1};
+                try {
+                    combine.Apply(op);
+                } catch (const std::runtime_error &) {
+                    failed[t]++;
+                }
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    int total = 0;
+    for (int f : failed) {
+        total += f;
+    }
+    EXPECT_GE(total, threads * per_thread / 100);
+    EXPECT_LE(counter, long(threads) * (per_thread - per_thread / 100));
+}
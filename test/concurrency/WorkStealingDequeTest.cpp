@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/WorkStealingDeque.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+TEST(WorkStealingDequeTest, OwnerTakesNewest) {
+    WorkStealingDeque<int> deque(4);
+    int items[3] = {0, 1, 2};
+    for (int &i : items) {
+        deque.Push(&i);
+    }
+
+    EXPECT_EQ(&items[2], deque.Pop());
+    EXPECT_EQ(&items[0], deque.Steal());
+    EXPECT_EQ(&items[1], deque.Pop());
+    EXPECT_EQ(nullptr, deque.Pop());
+    EXPECT_EQ(nullptr, deque.Steal());
+}
+
+TEST(WorkStealingDequeTest, Grows) {
+    WorkStealingDeque<int> deque(2);
+    vector<int> items(100);
+    for (int &i : items) {
+        deque.Push(&i);
+    }
+    EXPECT_EQ(100, deque.Size());
+
+    // Steal half so that live items wrap around the new buffer
+    for (int i = 0; i < 50; i++) {
+        ASSERT_EQ(&items[i], deque.Steal());
+    }
+    for (int i = 99; i >= 50; i--) {
+        ASSERT_EQ(&items[i], deque.Pop());
+    }
+}
+
+TEST(WorkStealingDequeTest, EveryItemTakenOnce) {
+    const int count = 200000;
+    WorkStealingDeque<int> deque(16);
+    vector<int> items(count);
+    vector<atomic<int>> taken(count);
+    for (auto &t : taken) {
+        t = 0;
+    }
+
+    atomic<bool> done(false);
+    auto take = [&](int *item) { taken[item - &items[0]]++; };
+    vector<thread> thieves;
+    for (int i = 0; i < 3; i++) {
+        thieves.emplace_back([&]() {
+            while (!done) {
+                int *item = deque.Steal();
+                if (item != nullptr) {
+                    take(item);
+                }
+            }
+        });
+    }
+
+    // Owner pops some of its own work back, thieves race for the rest
+    for (int i = 0; i < count; i++) {
+        deque.Push(&items[i]);
+        if (i % 3 == 0) {
+            int *item = deque.Pop();
+            if (item != nullptr) {
+                take(item);
+            }
+        }
+    }
+    for (int *item = deque.Pop(); item != nullptr; item = deque.Pop()) {
+        take(item);
+    }
+    done = true;
+    for (auto &t : thieves) {
+        t.join();
+    }
+
+    for (int i = 0; i < count; i++) {
+        ASSERT_EQ(1, taken[i].load()) << "item " << i;
+    }
+}
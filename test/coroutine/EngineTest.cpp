@@ -1,8 +1,12 @@
 #include "gtest/gtest.h"
 
+#include <chrono>
 #include <iostream>
 #include <sstream>
 
+#include <sys/epoll.h>
+#include <unistd.h>
+
 #include <afina/coroutine/Engine.h>
 
 void _calculator_add(int &result, int left, int right) { result = left + right; }
@@ -62,3 +66,139 @@ TEST(CoroutineTest, Printer) {
     engine.start(_printer, engine, result);
     ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
 }
+
+void _counter(Afina::Coroutine::Engine &pe, int &counter, int steps) {
+    for (int i = 0; i < steps; i++) {
+        counter++;
+        pe.yield();
+    }
+}
+
+void _spawner(Afina::Coroutine::Engine &pe, int &counter) {
+    // Routines outlive the main one, engine runs them to the end anyway
+    pe.run(_counter, pe, counter, 3);
+    pe.run(_counter, pe, counter, 5);
+}
+
+TEST(CoroutineTest, RunsUntilAllDone) {
+    Afina::Coroutine::Engine engine;
+
+    int counter = 0;
+    engine.start(_spawner, engine, counter);
+    ASSERT_EQ(8, counter);
+}
+
+void _short(int &counter) { counter++; }
+
+void _recycler(Afina::Coroutine::Engine &pe, int &counter) {
+    // Every routine is done before the next one is created, so all but the first reuse the same context
+    for (int i = 0; i < 10; i++) {
+        pe.sched(pe.run(_short, counter));
+    }
+}
+
+TEST(CoroutineTest, RecyclesContexts) {
+    Afina::Coroutine::Engine engine(4);
+
+    int counter = 0;
+    engine.start(_recycler, engine, counter);
+    ASSERT_EQ(10, counter);
+    // main routine and the first short one need new contexts
+    EXPECT_EQ(2, engine.pool_stats().misses);
+    EXPECT_EQ(9, engine.pool_stats().hits);
+}
+
+void _blocked(Afina::Coroutine::Engine &pe, std::stringstream &out) {
+    out << "B1 ";
+    pe.block();
+    out << "B2 ";
+}
+
+void _unblocker(Afina::Coroutine::Engine &pe, std::stringstream &out) {
+    void *blocked = pe.run(_blocked, pe, out);
+    pe.sched(blocked);
+
+    // Blocked routine is skipped until unblock
+    out << "M1 ";
+    pe.yield();
+    out << "M2 ";
+    pe.unblock(blocked);
+    pe.yield();
+    out << "M3";
+}
+
+TEST(CoroutineTest, BlockUnblock) {
+    Afina::Coroutine::Engine engine;
+
+    std::stringstream out;
+    engine.start(_unblocker, engine, out);
+    ASSERT_EQ("B1 M1 M2 B2 M3", out.str());
+}
+
+void _sleeper(Afina::Coroutine::Engine &pe, std::stringstream &out, int ms) {
+    pe.sleep_for(std::chrono::milliseconds(ms));
+    out << ms << " ";
+}
+
+void _sleepers(Afina::Coroutine::Engine &pe, std::stringstream &out) {
+    pe.run(_sleeper, pe, out, 30);
+    pe.run(_sleeper, pe, out, 10);
+    pe.run(_sleeper, pe, out, 20);
+}
+
+TEST(CoroutineTest, SleepFor) {
+    Afina::Coroutine::Engine engine;
+
+    std::stringstream out;
+    auto start = std::chrono::steady_clock::now();
+    engine.start(_sleepers, engine, out);
+    ASSERT_EQ("10 20 30 ", out.str());
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(30));
+}
+
+void _reader(Afina::Coroutine::Engine &pe, int fd, std::string &result) {
+    // Nothing is there yet, routine blocks instead of spinning
+    char buf[16];
+    uint32_t events = pe.wait(fd, EPOLLIN);
+    ASSERT_TRUE(events & EPOLLIN);
+    ssize_t n = read(fd, buf, sizeof(buf));
+    ASSERT_GT(n, 0);
+    result.assign(buf, n);
+
+    ASSERT_EQ(0, pe.wait(fd, EPOLLIN, std::chrono::milliseconds(10)));
+}
+
+void _writer(Afina::Coroutine::Engine &pe, int fd) {
+    pe.sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(4, write(fd, "ping", 4));
+}
+
+void _pipe(Afina::Coroutine::Engine &pe, int *fds, std::string &result) {
+    pe.run(_reader, pe, int(fds[0]), result);
+    pe.run(_writer, pe, int(fds[1]));
+}
+
+TEST(CoroutineTest, WaitsForDescriptor) {
+    Afina::Coroutine::Engine engine;
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    std::string result;
+    engine.start(_pipe, engine, static_cast<int *>(fds), result);
+    close(fds[0]);
+    close(fds[1]);
+    ASSERT_EQ("ping", result);
+}
+
+void _forever(int &counter, Afina::Coroutine::Engine &pe) {
+    pe.block();
+    counter++;
+}
+
+TEST(CoroutineTest, DropsDeadlocked) {
+    Afina::Coroutine::Engine engine;
+
+    int counter = 0;
+    engine.start(_forever, counter, engine);
+    ASSERT_EQ(0, counter);
+}
@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <afina/coroutine/Scheduler.h>
+
+using Afina::Coroutine::Scheduler;
+
+void _sched_counter(Scheduler &s, std::atomic<int> &counter, int steps) {
+    for (int i = 0; i < steps; i++) {
+        counter++;
+        s.yield();
+    }
+}
+
+void _sched_spawner(Scheduler &s, std::atomic<int> &counter) {
+    for (int i = 0; i < 100; i++) {
+        ASSERT_NE(nullptr, s.run(_sched_counter, s, counter, 10));
+    }
+}
+
+TEST(SchedulerTest, RunsUntilAllDone) {
+    Scheduler scheduler(4);
+
+    std::atomic<int> counter(0);
+    scheduler.start(_sched_spawner, scheduler, counter);
+    ASSERT_EQ(1000, counter.load());
+    ASSERT_EQ(101, scheduler.stats().spawned);
+}
+
+struct Threads {
+    std::mutex lock;
+    std::set<std::thread::id> seen;
+};
+
+void _sched_busy(Threads &threads) {
+    // Keeps its worker thread busy, so the rest has to be stolen by others
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::lock_guard<std::mutex> lock(threads.lock);
+    threads.seen.insert(std::this_thread::get_id());
+}
+
+void _sched_busy_spawner(Scheduler &s, Threads &threads) {
+    for (int i = 0; i < 8; i++) {
+        s.run(_sched_busy, threads);
+    }
+}
+
+TEST(SchedulerTest, StealsWork) {
+    Scheduler scheduler(4);
+
+    Threads threads;
+    scheduler.start(_sched_busy_spawner, scheduler, threads);
+    EXPECT_GT(threads.seen.size(), 1);
+    EXPECT_GT(scheduler.stats().steals, 0);
+}
+
+struct Handoff {
+    std::atomic<void *> waiter{nullptr};
+    std::atomic<int> round{0};
+};
+
+void _sched_waiter(Scheduler &s, Handoff &h) {
+    for (int i = 0; i < 100; i++) {
+        // Unblock could come before block, it is not lost then
+        h.waiter = s.current();
+        while (h.round.load() == i) {
+            s.block();
+        }
+    }
+}
+
+void _sched_waker(Scheduler &s, Handoff &h) {
+    for (int i = 0; i < 100; i++) {
+        void *waiter;
+        while ((waiter = h.waiter.exchange(nullptr)) == nullptr) {
+            s.yield();
+        }
+        h.round++;
+        s.unblock(waiter);
+    }
+}
+
+void _sched_pair(Scheduler &s, Handoff &h) {
+    s.run(_sched_waiter, s, h);
+    s.run(_sched_waker, s, h);
+}
+
+TEST(SchedulerTest, BlockUnblock) {
+    Scheduler scheduler(3);
+
+    Handoff h;
+    scheduler.start(_sched_pair, scheduler, h);
+    ASSERT_EQ(100, h.round.load());
+}
+
+void _sched_external(Scheduler &s, bool &resumed) {
+    void *self = s.current();
+    std::thread waker([&s, self]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        s.unblock(self);
+    });
+
+    // Workers sleep until thread outside of scheduler unblocks routine
+    s.block();
+    resumed = true;
+    waker.join();
+}
+
+TEST(SchedulerTest, UnblockFromOtherThread) {
+    Scheduler scheduler(2);
+
+    bool resumed = false;
+    scheduler.start(_sched_external, scheduler, resumed);
+    ASSERT_TRUE(resumed);
+}
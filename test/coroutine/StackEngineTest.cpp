@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+#include <afina/coroutine/StackEngine.h>
+
+using Afina::Coroutine::StackEngine;
+
+void _stack_add(int &result, int left, int right) { result = left + right; }
+
+TEST(StackEngineTest, SimpleStart) {
+    StackEngine engine;
+
+    int result;
+    engine.start(_stack_add, result, 1, 2);
+
+    ASSERT_EQ(3, result);
+}
+
+void _stack_print(StackEngine &pe, std::stringstream &out, char name, void *&other, int steps) {
+    for (int i = 1; i <= steps; i++) {
+        out << name << i << " ";
+        pe.sched(other);
+    }
+}
+
+void _stack_printer(StackEngine &pe, std::string &result) {
+    std::stringstream out;
+    void *pa = nullptr, *pb = nullptr;
+    pa = pe.run(_stack_print, pe, out, 'A', pb, 3);
+    pb = pe.run(_stack_print, pe, out, 'B', pa, 3);
+
+    // Routines ping pong greedely, then control gets back once A is done and B has nowhere to go
+    pe.sched(pa);
+    out << "END";
+    result = out.str();
+}
+
+TEST(StackEngineTest, Printer) {
+    StackEngine engine;
+
+    std::string result;
+    engine.start(_stack_printer, engine, result);
+    ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
+}
+
+void _stack_counter(StackEngine &pe, int &counter, int steps) {
+    for (int i = 0; i < steps; i++) {
+        counter++;
+        pe.yield();
+    }
+}
+
+void _stack_spawner(StackEngine &pe, int &counter) {
+    for (int i = 0; i < 100; i++) {
+        ASSERT_NE(nullptr, pe.run(_stack_counter, pe, counter, 10));
+    }
+}
+
+TEST(StackEngineTest, RunsUntilAllDone) {
+    StackEngine engine;
+
+    int counter = 0;
+    engine.start(_stack_spawner, engine, counter);
+    ASSERT_EQ(1000, counter);
+}
+
+void _stack_turns(StackEngine &pe, int &turns, int &total) {
+    while (total < 30) {
+        turns++;
+        total++;
+        pe.yield();
+    }
+}
+
+void _stack_three(StackEngine &pe, int *turns, int &total) {
+    for (int i = 0; i < 3; i++) {
+        pe.run(_stack_turns, pe, turns[i], total);
+    }
+}
+
+TEST(StackEngineTest, YieldIsRoundRobin) {
+    StackEngine engine;
+
+    // Every routine gets its turn, none is starved by the other two
+    int turns[3] = {0, 0, 0};
+    int total = 0;
+    engine.start(_stack_three, engine, static_cast<int *>(turns), total);
+    EXPECT_EQ(10, turns[0]);
+    EXPECT_EQ(10, turns[1]);
+    EXPECT_EQ(10, turns[2]);
+}
+
+int _stack_deep(StackEngine &pe, int depth) {
+    // Locals of every frame have to survive switches
+    volatile char frame[256];
+    frame[0] = char(depth);
+    if (depth == 0) {
+        pe.yield();
+        return 0;
+    }
+    int below = _stack_deep(pe, depth - 1);
+    return below + frame[0];
+}
+
+void _stack_recurse(StackEngine &pe, int &result, int depth) { result = _stack_deep(pe, depth); }
+
+void _stack_two_deep(StackEngine &pe, int &left, int &right) {
+    pe.run(_stack_recurse, pe, left, 100);
+    pe.run(_stack_recurse, pe, right, 100);
+}
+
+TEST(StackEngineTest, KeepsDeepStacks) {
+    StackEngine engine;
+
+    int left = 0, right = 0;
+    engine.start(_stack_two_deep, engine, left, right);
+    ASSERT_EQ(5050, left);
+    ASSERT_EQ(5050, right);
+}
+
+void _stack_short(int &counter) { counter++; }
+
+void _stack_burst(StackEngine &pe, int &counter) {
+    // Ten routines alive at once, then ten more reusing their stacks, pool keeps four of them
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < 10; i++) {
+            pe.run(_stack_short, counter);
+        }
+        pe.yield();
+        while (counter < 10 * (round + 1)) {
+            pe.yield();
+        }
+    }
+}
+
+TEST(StackEngineTest, RecyclesStacks) {
+    StackEngine engine(StackEngine::default_stack_size, 4);
+
+    int counter = 0;
+    engine.start(_stack_burst, engine, counter);
+    ASSERT_EQ(20, counter);
+    EXPECT_EQ(4, engine.pool_stats().hits);
+    EXPECT_EQ(17, engine.pool_stats().misses);
+    EXPECT_EQ(4, engine.pool_stats().size);
+}
+
+void _stack_noop(StackEngine &pe) {}
+
+TEST(StackEngineTest, RunNeedsStart) {
+    StackEngine engine;
+    ASSERT_EQ(nullptr, engine.run(_stack_noop, engine));
+}
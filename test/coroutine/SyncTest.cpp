@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <vector>
+
+#include <afina/coroutine/Channel.h>
+#include <afina/coroutine/Engine.h>
+#include <afina/coroutine/Mutex.h>
+
+using namespace Afina::Coroutine;
+
+void _locker(Engine &pe, Mutex &mutex, std::stringstream &out, char name) {
+    // Routines switch inside of critical section, but don't get into it together
+    for (int i = 0; i < 2; i++) {
+        mutex.lock();
+        out << name << "+ ";
+        pe.yield();
+        out << name << "- ";
+        mutex.unlock();
+        pe.yield();
+    }
+}
+
+void _lockers(Engine &pe, Mutex &mutex, std::stringstream &out) {
+    pe.run(_locker, pe, mutex, out, 'A');
+    pe.run(_locker, pe, mutex, out, 'B');
+}
+
+TEST(SyncTest, MutexExcludes) {
+    Engine engine;
+    Mutex mutex(engine);
+
+    std::stringstream out;
+    engine.start(_lockers, engine, mutex, out);
+    ASSERT_EQ("B+ B- A+ A- B+ B- A+ A- ", out.str());
+    ASSERT_TRUE(mutex.try_lock());
+}
+
+void _producer(Channel<int> &channel, int from, int count) {
+    for (int i = from; i < from + count; i++) {
+        ASSERT_TRUE(channel.send(i));
+    }
+}
+
+void _consumer(Channel<int> &channel, std::vector<int> &received) {
+    int value;
+    while (channel.recv(value)) {
+        received.push_back(value);
+    }
+}
+
+void _pipeline(Engine &pe, Channel<int> &channel, std::vector<int> &received) {
+    pe.run(_producer, channel, 0, 50);
+    pe.run(_producer, channel, 100, 50);
+    pe.run(_consumer, channel, received);
+}
+
+TEST(SyncTest, ChannelPassesEverything) {
+    Engine engine;
+    Channel<int> channel(engine, 4);
+
+    std::vector<int> received;
+    engine.start(_pipeline, engine, channel, received);
+
+    // Nobody closed channel, consumer is blocked forever and dropped once producers are done
+    ASSERT_EQ(100, received.size());
+    int sum = 0;
+    for (int v : received) {
+        sum += v;
+    }
+    ASSERT_EQ(49 * 50 / 2 + 100 * 50 + 49 * 50 / 2, sum);
+}
+
+void _closing(Engine &pe, Channel<int> &channel, std::vector<int> &received) {
+    void *consumer = pe.run(_consumer, channel, received);
+    pe.sched(consumer);
+    channel.send(1);
+    channel.send(2);
+    channel.close();
+    ASSERT_FALSE(channel.send(3));
+}
+
+TEST(SyncTest, ChannelClose) {
+    Engine engine;
+    Channel<int> channel(engine, 4);
+
+    std::vector<int> received;
+    engine.start(_closing, engine, channel, received);
+    ASSERT_EQ(std::vector<int>({1, 2}), received);
+}
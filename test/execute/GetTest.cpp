@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+#include <string>
+
+#include <afina/execute/Get.h>
+
+#include "storage/HashLRU.h"
+
+using namespace Afina::Backend;
+using namespace Afina::Execute;
+using namespace std;
+
+TEST(GetTest, Chunks) {
+    HashLRU storage;
+    storage.Put("KEY1", "val1");
+    storage.Put("KEY2", "val2");
+
+    Get get({"KEY1", "MISSING", "KEY2"});
+    Command::Chunks chunks;
+    get.Execute(storage, "", chunks);
+
+    std::string joined;
+    for (auto &chunk : chunks) {
+        joined += *chunk;
+    }
+    EXPECT_EQ(joined, "VALUE KEY1 0 4\r\nval1\r\nVALUE KEY2 0 4\r\nval2\r\nEND");
+
+    std::string out;
+    get.Execute(storage, "", out);
+    EXPECT_EQ(out, joined);
+}
+
+namespace {
+
+class StringOutput : public Output {
+public:
+    void Append(const char *data, std::size_t size) override { result.append(data, size); }
+    void Append(std::shared_ptr<const std::string> data) override {
+        result += *data;
+        shared++;
+    }
+
+    std::string result;
+    int shared = 0;
+};
+
+} // namespace
+
+TEST(GetTest, Output) {
+    HashLRU storage;
+    storage.Put("KEY1", "val1");
+    storage.Put("KEY2", "val2");
+
+    Get get({"KEY1", "MISSING", "KEY2"});
+    StringOutput out;
+    get.Execute(storage, "", out);
+    EXPECT_EQ(out.result, "VALUE KEY1 0 4\r\nval1\r\nVALUE KEY2 0 4\r\nval2\r\nEND");
+    EXPECT_EQ(out.shared, 2);
+}
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+#include <memory>
+#include <vector>
+
+#include <poll.h>
+
+#include "network/mt_nonblocking/Balancer.h"
+#include "network/mt_nonblocking/Connection.h"
+#include "network/mt_nonblocking/Registry.h"
+
+using namespace Afina::Network::MTnonblock;
+using namespace std;
+
+static bool Readable(int fd) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    return poll(&pfd, 1, 0) == 1;
+}
+
+TEST(BalancerTest, FindsIdle) {
+    vector<shared_ptr<Registry>> registries;
+    for (int i = 0; i < 3; i++) {
+        registries.push_back(make_shared<Registry>(0));
+    }
+    Balancer balancer(registries);
+
+    balancer.Report(0, 5);
+    balancer.Report(1, 2);
+    balancer.Report(2, 1);
+    EXPECT_EQ(-1, balancer.Idle(0));
+
+    // Worker never picks itself
+    balancer.Report(2, 0);
+    EXPECT_EQ(2, balancer.Idle(0));
+    EXPECT_EQ(2, balancer.Idle(1));
+    EXPECT_EQ(-1, balancer.Idle(2));
+}
+
+TEST(BalancerTest, Migrates) {
+    vector<shared_ptr<Registry>> registries{make_shared<Registry>(0), make_shared<Registry>(0)};
+    Balancer balancer(registries);
+
+    Connection a(100, nullptr), b(101, nullptr);
+    registries[0]->Add(&a);
+    registries[0]->Add(&b);
+    EXPECT_FALSE(Readable(balancer.Fd(1)));
+
+    balancer.Migrate(0, 1, &a);
+    balancer.Migrate(0, 1, &b);
+    EXPECT_TRUE(Readable(balancer.Fd(1)));
+    EXPECT_FALSE(Readable(balancer.Fd(0)));
+
+    vector<Connection *> mail;
+    balancer.Take(1, mail);
+    ASSERT_EQ(2, mail.size());
+    EXPECT_EQ(&a, mail[0]);
+    EXPECT_EQ(&b, mail[1]);
+    EXPECT_FALSE(Readable(balancer.Fd(1)));
+
+    // Connections belong to the registry of the new owner
+    EXPECT_TRUE(registries[0]->Take().empty());
+    EXPECT_EQ(2, registries[1]->Take().size());
+}
@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "network/Handoff.h"
+
+using namespace Afina::Network;
+using namespace std;
+
+TEST(HandoffTest, PassesDescriptors) {
+    int pair[2], pipe_fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pair));
+    ASSERT_EQ(0, pipe(pipe_fds));
+
+    SendDescriptors(pair[0], {pipe_fds[0], pipe_fds[1]});
+    vector<int> fds = ReceiveDescriptors(pair[1]);
+    ASSERT_EQ(2, fds.size());
+    EXPECT_NE(pipe_fds[0], fds[0]);
+    EXPECT_EQ(FD_CLOEXEC, fcntl(fds[0], F_GETFD) & FD_CLOEXEC);
+
+    // Received ones refer to the same pipe
+    ASSERT_EQ(1, write(fds[1], "x", 1));
+    char c = 0;
+    ASSERT_EQ(1, read(pipe_fds[0], &c, 1));
+    EXPECT_EQ('x', c);
+
+    for (int fd : {pair[0], pair[1], pipe_fds[0], pipe_fds[1], fds[0], fds[1]}) {
+        close(fd);
+    }
+}
+
+TEST(HandoffTest, PeerGone) {
+    int pair[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pair));
+    close(pair[0]);
+    EXPECT_TRUE(ReceiveDescriptors(pair[1]).empty());
+    close(pair[1]);
+}
@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "network/OutputBuffer.h"
+
+using namespace Afina::Network;
+using namespace std;
+
+class OutputBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(0, pipe(fds));
+        ASSERT_EQ(0, fcntl(fds[1], F_SETFL, O_NONBLOCK));
+    }
+
+    void TearDown() override {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    string Receive(size_t size) {
+        string result(size, '\0');
+        for (size_t got = 0; got < size;) {
+            ssize_t n = read(fds[0], &result[got], size - got);
+            if (n <= 0) {
+                break;
+            }
+            got += n;
+        }
+        return result;
+    }
+
+    int fds[2];
+};
+
+TEST_F(OutputBufferTest, Burst) {
+    OutputBuffer output(64);
+    string expected;
+    for (int i = 0; i < 100; i++) {
+        string response = "VALUE key" + to_string(i) + " 0 1\r\nx\r\nEND\r\n";
+        output.Append(response.data(), response.size());
+        expected += response;
+    }
+    EXPECT_EQ(expected.size(), output.Size());
+
+    // Whole burst goes out with one call
+    ASSERT_EQ(ssize_t(expected.size()), output.WriteTo(fds[1]));
+    EXPECT_TRUE(output.Empty());
+    EXPECT_EQ(expected, Receive(expected.size()));
+
+    // Blocks are reused
+    output.Append("END\r\n", 5);
+    ASSERT_EQ(5, output.WriteTo(fds[1]));
+    EXPECT_EQ("END\r\n", Receive(5));
+}
+
+TEST_F(OutputBufferTest, SharedValue) {
+    OutputBuffer output(64);
+    auto small = make_shared<const string>("small");
+    auto large = make_shared<const string>(4096, 'v');
+
+    output.Append("VALUE a 0 5\r\n", 13);
+    output.Append(small);
+    output.Append("\r\n", 2);
+    output.Append(large);
+    output.Append("\r\n", 2);
+
+    // Large value is referenced, small one is copied
+    EXPECT_EQ(2, large.use_count());
+    EXPECT_EQ(1, small.use_count());
+
+    string expected = "VALUE a 0 5\r\nsmall\r\n" + *large + "\r\n";
+    ASSERT_EQ(ssize_t(expected.size()), output.WriteTo(fds[1]));
+    EXPECT_EQ(expected, Receive(expected.size()));
+    EXPECT_EQ(1, large.use_count());
+}
+
+TEST_F(OutputBufferTest, PartialWrite) {
+    OutputBuffer output(4096);
+    string expected;
+    for (int i = 0; i < 1000; i++) {
+        string response(251, 'a' + i % 26);
+        output.Append(response.data(), response.size());
+        expected += response;
+    }
+
+    // Pipe can't take everything at once, the rest is kept for the next call
+    string received;
+    while (!output.Empty()) {
+        ssize_t n = output.WriteTo(fds[1]);
+        if (n > 0) {
+            received += Receive(n);
+        }
+    }
+    EXPECT_EQ(expected, received);
+}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include <string>
+
+#include <unistd.h>
+
+#include "network/ReadBuffer.h"
+
+using namespace Afina::Network;
+using namespace std;
+
+class ReadBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override { ASSERT_EQ(0, pipe(fds)); }
+
+    void TearDown() override {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    void Send(const string &data) { ASSERT_EQ(ssize_t(data.size()), write(fds[1], data.data(), data.size())); }
+
+    int fds[2];
+};
+
+TEST_F(ReadBufferTest, Cursor) {
+    ReadBuffer buffer(64);
+    Send("get a\r\nget b\r\n");
+    ASSERT_EQ(14, buffer.ReadFrom(fds[0]));
+
+    const char *data = buffer.Data();
+    buffer.Consume(7);
+    EXPECT_EQ(data + 7, buffer.Data());
+    EXPECT_EQ("get b\r\n", string(buffer.Data(), buffer.Size()));
+
+    buffer.Consume(7);
+    EXPECT_EQ(0, buffer.Size());
+}
+
+TEST_F(ReadBufferTest, KeepsTail) {
+    ReadBuffer buffer(16);
+    Send("0123456789abcd");
+    ASSERT_EQ(14, buffer.ReadFrom(fds[0]));
+    buffer.Consume(12);
+
+    // Free space at the end is too small, unconsumed tail moves to the front
+    Send("efghijklmn");
+    ASSERT_EQ(10, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ("cdefghijklmn", string(buffer.Data(), buffer.Size()));
+}
+
+TEST_F(ReadBufferTest, GrowsWhenFull) {
+    ReadBuffer buffer(16);
+    string data(100, 'x');
+    Send(data);
+
+    string got;
+    while (got.size() < data.size()) {
+        ASSERT_GT(buffer.ReadFrom(fds[0]), 0);
+        got.assign(buffer.Data(), buffer.Size());
+    }
+    EXPECT_EQ(data, got);
+}
+
+TEST_F(ReadBufferTest, ExpectedReadAtOnce) {
+    ReadBuffer buffer(16);
+    string body(1000, 'v');
+    Send(body);
+
+    ASSERT_EQ(1000, buffer.ReadFrom(fds[0], body.size()));
+    EXPECT_EQ(body, string(buffer.Data(), buffer.Size()));
+
+    // Memory is given back once large piece is consumed
+    buffer.Consume(body.size());
+    Send("get a\r\n");
+    ASSERT_EQ(7, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ("get a\r\n", string(buffer.Data(), buffer.Size()));
+}
@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <vector>
+
+#include "network/TimerWheel.h"
+
+using namespace Afina::Network;
+using namespace std;
+
+TEST(TimerWheelTest, Fires) {
+    TimerWheel wheel(1000, 10);
+    TimerWheel::Timer timer;
+    wheel.Schedule(timer, 1055);
+    EXPECT_TRUE(timer.Armed());
+    EXPECT_EQ(60, wheel.Timeout(1000));
+
+    vector<TimerWheel::Timer *> expired;
+    wheel.Advance(1050, expired);
+    EXPECT_TRUE(expired.empty());
+
+    wheel.Advance(1060, expired);
+    ASSERT_EQ(1, expired.size());
+    EXPECT_EQ(&timer, expired[0]);
+    EXPECT_FALSE(timer.Armed());
+    EXPECT_EQ(-1, wheel.Timeout(1060));
+}
+
+TEST(TimerWheelTest, Cancel) {
+    TimerWheel wheel(0, 10);
+    TimerWheel::Timer a, b;
+    wheel.Schedule(a, 100);
+    wheel.Schedule(b, 100);
+    wheel.Cancel(a);
+    EXPECT_FALSE(a.Armed());
+    EXPECT_EQ(1, wheel.Size());
+
+    {
+        // Destroyed timer leaves the wheel
+        TimerWheel::Timer c;
+        wheel.Schedule(c, 50);
+    }
+    EXPECT_EQ(1, wheel.Size());
+
+    vector<TimerWheel::Timer *> expired;
+    wheel.Advance(1000, expired);
+    ASSERT_EQ(1, expired.size());
+    EXPECT_EQ(&b, expired[0]);
+}
+
+TEST(TimerWheelTest, Levels) {
+    // Spread over all the levels, from a tick to days ahead
+    const uint64_t start = 123456;
+    vector<uint64_t> delays = {1, 9, 10, 639, 640, 641, 5000, 40959, 40960, 99999, 3000000, 86400000};
+    vector<TimerWheel::Timer> timers(delays.size());
+
+    TimerWheel wheel(start, 10);
+    for (size_t i = 0; i < delays.size(); i++) {
+        timers[i].data = &delays[i];
+        wheel.Schedule(timers[i], start + delays[i]);
+    }
+
+    // Advance in uneven steps and check every timer fires by the first step that is a tick past it
+    vector<TimerWheel::Timer *> expired;
+    size_t fired = 0;
+    uint64_t before = start;
+    for (uint64_t now = start; fired < delays.size(); before = now, now += 7 + now % 1013) {
+        int timeout = wheel.Timeout(now);
+        ASSERT_GE(timeout, 0);
+
+        expired.clear();
+        wheel.Advance(now, expired);
+        for (auto timer : expired) {
+            uint64_t due = start + *static_cast<uint64_t *>(timer->data);
+            EXPECT_LE(due, now);
+            EXPECT_GT(due + 10, before);
+        }
+        fired += expired.size();
+    }
+    EXPECT_EQ(0, wheel.Size());
+}
+
+TEST(TimerWheelTest, Reschedule) {
+    TimerWheel wheel(0, 10);
+    TimerWheel::Timer timer;
+    wheel.Schedule(timer, 100);
+    wheel.Schedule(timer, 5000);
+    EXPECT_EQ(1, wheel.Size());
+
+    vector<TimerWheel::Timer *> expired;
+    wheel.Advance(4990, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.Advance(5000, expired);
+    EXPECT_EQ(1, expired.size());
+}
@@ -1,7 +1,10 @@
 #include "gtest/gtest.h"
+#include <atomic>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include <afina/execute/Add.h>
@@ -10,7 +13,14 @@
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/ClockCache.h"
+#include "storage/FlatCombineLRU.h"
+#include "storage/HashLRU.h"
+#include "storage/ReadMostlyLRU.h"
+#include "storage/ShardedLRU.h"
 #include "storage/SimpleLRU.h"
+#include "storage/SlabLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
@@ -114,3 +124,438 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(HashLRUTest, PutGetDelete) {
+    HashLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(value, "val1");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ(value, "val4");
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+}
+
+TEST(HashLRUTest, EvictLeastRecent) {
+    const size_t length = 20;
+    HashLRU storage(2 * 1000 * length);
+
+    for (long i = 0; i < 1000; ++i) {
+        storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length));
+    }
+
+    // Touch first 100 keys so that next 100 become the oldest ones
+    std::string res;
+    for (long i = 0; i < 100; ++i) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+
+    for (long i = 1000; i < 1100; ++i) {
+        storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length));
+    }
+
+    for (long i = 0; i < 1100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        if (i >= 100 && i < 200) {
+            EXPECT_FALSE(storage.Get(key, res));
+        } else {
+            EXPECT_TRUE(storage.Get(key, res));
+            EXPECT_EQ(res, pad_space("Val " + std::to_string(i), length));
+        }
+    }
+}
+
+TEST(HashLRUTest, ManyKeys) {
+    const size_t count = 1000000;
+    std::unique_ptr<HashLRU> storage(new HashLRU(count * 32));
+
+    for (size_t i = 0; i < count; ++i) {
+        auto key = std::to_string(i);
+        EXPECT_TRUE(storage->Put(key, key));
+    }
+
+    std::string res;
+    for (size_t i = 0; i < count; i += 7) {
+        EXPECT_TRUE(storage->Get(std::to_string(i), res));
+    }
+    for (size_t i = 0; i < count; i += 2) {
+        EXPECT_TRUE(storage->Delete(std::to_string(i)));
+    }
+    for (size_t i = 1; i < count; i += 2) {
+        auto key = std::to_string(i);
+        EXPECT_TRUE(storage->Get(key, res));
+        EXPECT_EQ(res, key);
+    }
+
+    // Destructor must not recurse over the list
+    storage.reset();
+}
+
+TEST(ShardedLRUTest, ConcurrentPutGet) {
+    const size_t length = 20;
+    const int threads = 4, per_thread = 2000;
+    ShardedLRU storage(2 * threads * per_thread * length, 8);
+
+    std::vector<std::thread> workers;
+    std::atomic<int> failed(0);
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&storage, &failed, t, per_thread, length]() {
+            std::string res;
+            for (int i = 0; i < per_thread; i++) {
+                auto key = pad_space("Key " + std::to_string(t) + " " + std::to_string(i), length);
+                storage.Put(key, key);
+                if (!storage.Get(key, res) || res != key) {
+                    failed++;
+                }
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    EXPECT_EQ(failed.load(), 0);
+}
+
+TEST(ShardedLRUTest, GlobalBudget) {
+    const size_t length = 20;
+    ShardedLRU storage(2 * 1000 * length, 4);
+
+    for (long i = 0; i < 2000; ++i) {
+        storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length));
+    }
+
+    int present = 0;
+    std::string res;
+    for (long i = 0; i < 2000; ++i) {
+        if (storage.Get(pad_space("Key " + std::to_string(i), length), res)) {
+            present++;
+        }
+    }
+    EXPECT_LE(present, 1000);
+    EXPECT_GT(present, 900);
+}
+
+TEST(ShardedLRUTest, SmallBudgetKeepsUsableSlices) {
+    // 1024 bytes can't be split into 64 partitions, pair of 500 bytes must still fit
+    ShardedLRU storage(1024, 64);
+    EXPECT_EQ(storage.Shards(), 1);
+    EXPECT_TRUE(storage.Put("KEY", std::string(500, 'v')));
+
+    ShardedLRU large(64 * ShardedLRU::min_slice, 128);
+    EXPECT_EQ(large.Shards(), 64);
+}
+
+TEST(StorageTest, OverwriteRespectsBudget) {
+    SimpleLRU storage(100);
+
+    storage.Put("KEY1", std::string(40, 'a'));
+    storage.Put("KEY2", std::string(40, 'b'));
+    storage.Put("KEY1", std::string(90, 'c'));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(value, std::string(90, 'c'));
+}
+
+TEST(ReadMostlyLRUTest, HitsPromotedBeforeEviction) {
+    ReadMostlyLRU storage(12);
+
+    storage.Put("KEY1", "v1");
+    storage.Put("KEY2", "v2");
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    storage.Put("KEY3", "v3");
+
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(value, "v1");
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+}
+
+TEST(ReadMostlyLRUTest, ConcurrentReadersAndWriters) {
+    const size_t length = 20;
+    const int keys = 1000;
+    ReadMostlyLRU storage(keys * length);
+
+    for (int i = 0; i < keys; i++) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        storage.Put(key, "");
+    }
+
+    std::vector<std::thread> workers;
+    std::atomic<int> failed(0);
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&storage, &failed, t, keys, length]() {
+            std::string res;
+            for (int i = 0; i < 20000; i++) {
+                auto key = pad_space("Key " + std::to_string((i * 7 + t) % keys), length);
+                if (i % 20 == 0) {
+                    storage.Delete(key);
+                    storage.Put(key, "");
+                } else if (storage.Get(key, res) && !res.empty()) {
+                    failed++;
+                }
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    EXPECT_EQ(failed.load(), 0);
+}
+
+TEST(ClockCacheTest, PutGetDelete) {
+    ClockCache storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(value, "val1");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ(value, "val4");
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(ClockCacheTest, ReferencedSurvive) {
+    const size_t length = 20;
+    ClockCache storage(2 * 1000 * length);
+
+    for (long i = 0; i < 1000; ++i) {
+        storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length));
+    }
+
+    std::string res;
+    for (long i = 0; i < 1000; i += 2) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+
+    // Only unreferenced entries get evicted on the first sweep
+    for (long i = 1000; i < 1500; ++i) {
+        storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length));
+    }
+    for (long i = 0; i < 1000; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        EXPECT_EQ(i % 2 == 0, storage.Get(key, res));
+    }
+}
+
+TEST(TinyLFUTest, PutGetDelete) {
+    TinyLFU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(value, "val1");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ(value, "val4");
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(TinyLFUTest, ScanResistant) {
+    const size_t length = 20;
+    TinyLFU storage(2 * 100 * length);
+
+    // Hot set used many times
+    std::string res;
+    for (int round = 0; round < 10; round++) {
+        for (long i = 0; i < 50; ++i) {
+            auto key = pad_space("Hot " + std::to_string(i), length);
+            if (!storage.Get(key, res)) {
+                storage.Put(key, key);
+            }
+        }
+    }
+
+    // One pass over many cold keys
+    for (long i = 0; i < 10000; ++i) {
+        auto key = pad_space("Cold " + std::to_string(i), length);
+        if (!storage.Get(key, res)) {
+            storage.Put(key, key);
+        }
+    }
+
+    int survived = 0;
+    for (long i = 0; i < 50; ++i) {
+        auto key = pad_space("Hot " + std::to_string(i), length);
+        if (storage.Get(key, res)) {
+            EXPECT_EQ(res, key);
+            survived++;
+        }
+    }
+    EXPECT_GE(survived, 45);
+}
+
+TEST(TinyLFUTest, HistorySurvivesGrowth) {
+    const size_t length = 20;
+    TinyLFU storage(2 * 3000 * length);
+
+    // Frequent keys first, then the cache warms up well past the initial sketch width
+    std::string res;
+    for (int round = 0; round < 10; round++) {
+        for (long i = 0; i < 50; ++i) {
+            auto key = pad_space("Hot " + std::to_string(i), length);
+            if (!storage.Get(key, res)) {
+                storage.Put(key, key);
+            }
+        }
+    }
+    for (long i = 0; i < 3000; ++i) {
+        auto key = pad_space("Warm " + std::to_string(i), length);
+        storage.Put(key, key);
+    }
+
+    // Scan competes with hot keys left in probation, they win only if sketch remembers them
+    for (long i = 0; i < 5000; ++i) {
+        auto key = pad_space("Cold " + std::to_string(i), length);
+        if (!storage.Get(key, res)) {
+            storage.Put(key, key);
+        }
+    }
+
+    int survived = 0;
+    for (long i = 0; i < 50; ++i) {
+        if (storage.Get(pad_space("Hot " + std::to_string(i), length), res)) {
+            survived++;
+        }
+    }
+    EXPECT_GE(survived, 45);
+}
+
+TEST(SlabLRUTest, PutGetDelete) {
+    SlabLRU storage(1 << 20);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", std::string(1000, 'x')));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(value, "val1");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ(value, std::string(1000, 'x'));
+
+    EXPECT_TRUE(storage.Put("KEY2", "val6"));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ(value, "val6");
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    // Doesn't fit any slab
+    EXPECT_FALSE(storage.Put("KEY4", std::string(2 << 20, 'y')));
+}
+
+TEST(SlabLRUTest, EvictWithinClass) {
+    const size_t length = 100;
+    SlabLRU storage(4 << 20);
+
+    for (long i = 0; i < 100000; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length)));
+    }
+
+    // Budget can't hold everything, freshest entries must be there
+    std::string res;
+    EXPECT_FALSE(storage.Get(pad_space("Key 0", length), res));
+    for (long i = 99000; i < 100000; ++i) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+        EXPECT_EQ(res, pad_space("Val " + std::to_string(i), length));
+    }
+}
+
+TEST(StorageTest, GetViewOutlivesUpdate) {
+    SimpleLRU simple;
+    HashLRU hash;
+    ClockCache clock;
+    for (Afina::Storage *storage : std::vector<Afina::Storage *>{&simple, &hash, &clock}) {
+        EXPECT_TRUE(storage->Put("KEY1", "val1"));
+
+        std::shared_ptr<const std::string> view;
+        EXPECT_TRUE(storage->GetView("KEY1", view));
+        EXPECT_EQ(*view, "val1");
+
+        // View stays the same whatever happens with the key
+        EXPECT_TRUE(storage->Put("KEY1", "val2"));
+        EXPECT_EQ(*view, "val1");
+        EXPECT_TRUE(storage->Delete("KEY1"));
+        EXPECT_EQ(*view, "val1");
+
+        EXPECT_FALSE(storage->GetView("KEY1", view));
+        EXPECT_EQ(*view, "val1");
+    }
+}
+
+TEST(FlatCombineLRUTest, SharedKeys) {
+    // More threads than slots, so batches mix calls of different threads on the same key
+    const int threads = 8, rounds = 2000;
+    FlatCombineLRU storage(1 << 20, 2);
+
+    std::vector<std::vector<char>> won(threads, std::vector<char>(rounds)), deleted(won);
+    std::atomic<int> failed(0);
+    // Puts and deletes go in separate runs, otherwise key deleted early could be put once again
+    auto run = [threads](std::function<void(int)> body) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back(body, t);
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+    };
+
+    run([&](int t) {
+        const std::string mine = "Value " + std::to_string(t);
+        std::string res;
+        for (int r = 0; r < rounds; r++) {
+            auto key = "Key " + std::to_string(r);
+            won[t][r] = storage.PutIfAbsent(key, mine);
+            // Each caller must get the result of its own call whoever has executed it
+            if (!storage.Get(key, res) || (won[t][r] && res != mine) || res.compare(0, 6, "Value ") != 0) {
+                failed++;
+            }
+        }
+    });
+    run([&](int t) {
+        for (int r = 0; r < rounds; r++) {
+            deleted[t][r] = storage.Delete("Key " + std::to_string(r));
+        }
+    });
+    EXPECT_EQ(failed.load(), 0);
+    EXPECT_GE(storage.BatchSize(), 1.0);
+
+    // Exactly one PutIfAbsent and one Delete succeed on every key
+    for (int r = 0; r < rounds; r++) {
+        int puts = 0, deletes = 0;
+        for (int t = 0; t < threads; t++) {
+            puts += won[t][r];
+            deletes += deleted[t][r];
+        }
+        EXPECT_EQ(puts, 1) << "Key " << r;
+        EXPECT_EQ(deletes, 1) << "Key " << r;
+    }
+}